@@ -11,6 +11,7 @@
 #include "constraint.hpp"
 #include "constraint_min_max.hpp"
 #include "constraint_one_of.hpp"
+#include "diff.hpp"
 #include "exceptions.hpp"
 #include "parser.hpp"
 #include "parser_info.hpp"
@@ -20,5 +21,6 @@
 #include "tag_scalar_vector.hpp"
 #include "tag_vector_of_tags.hpp"
 #include "utils.hpp"
+#include "xml_reader.hpp"
 
 #endif // CFGFILE__ALL_HPP__INCLUDED
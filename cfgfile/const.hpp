@@ -10,94 +10,342 @@
 // cfgfile include.
 #include "types.hpp"
 
+// C++ include.
+#include <cstddef>
+
 
 namespace cfgfile {
 
+namespace details {
+
 //
-// const_t
+// char_class_t
+//
+
+//! Class of the character for the lexical analyzer.
+enum class char_class_t : unsigned char {
+	//! Any other character.
+	other,
+	//! Space or tab.
+	space,
+	//! Carriage return or line feed.
+	new_line,
+	//! Start of the tag "{".
+	begin_tag,
+	//! Finish of the tag "}".
+	end_tag,
+	//! Quotes.
+	quotes,
+	//! Back slash.
+	back_slash,
+	//! Vertical bar, start of the comment.
+	vertical_bar
+}; // enum class char_class_t
+
+
+//
+// char_class_table_t
 //
 
+//! Classes of the characters with codes less than 256.
+struct char_class_table_t {
+	constexpr char_class_table_t()
+		:	m_classes()
+	{
+		m_classes[ static_cast< unsigned char > ( ' ' ) ] = char_class_t::space;
+		m_classes[ static_cast< unsigned char > ( '\t' ) ] = char_class_t::space;
+		m_classes[ static_cast< unsigned char > ( '\n' ) ] =
+			char_class_t::new_line;
+		m_classes[ static_cast< unsigned char > ( '\r' ) ] =
+			char_class_t::new_line;
+		m_classes[ static_cast< unsigned char > ( '{' ) ] =
+			char_class_t::begin_tag;
+		m_classes[ static_cast< unsigned char > ( '}' ) ] =
+			char_class_t::end_tag;
+		m_classes[ static_cast< unsigned char > ( '"' ) ] = char_class_t::quotes;
+		m_classes[ static_cast< unsigned char > ( '\\' ) ] =
+			char_class_t::back_slash;
+		m_classes[ static_cast< unsigned char > ( '|' ) ] =
+			char_class_t::vertical_bar;
+	}
+
+	//! \return Class of the character with the \a code.
+	constexpr char_class_t operator [] ( std::size_t code ) const
+	{
+		return m_classes[ code ];
+	}
+
+	//! Classes.
+	char_class_t m_classes[ 256 ];
+}; // struct char_class_table_t
+
+
+//
+// const_chars_t
+//
+
+//! Delimiters of any Trait, initialized with Trait::from_ascii().
+template< typename Trait, typename Char = typename Trait::char_t >
+struct const_chars_t {
+	static const Char c_begin_tag;
+	static const Char c_end_tag;
+	static const Char c_quotes;
+	static const Char c_n;
+	static const Char c_t;
+	static const Char c_r;
+	static const Char c_back_slash;
+	static const Char c_space;
+	static const Char c_tab;
+	static const Char c_carriage_return;
+	static const Char c_line_feed;
+	static const Char c_vertical_bar;
+	static const Char c_sharp;
+
+	//! \return Class of the \a ch.
+	static char_class_t char_class( Char ch )
+	{
+		if( ch == c_space || ch == c_tab )
+			return char_class_t::space;
+		else if( ch == c_carriage_return || ch == c_line_feed )
+			return char_class_t::new_line;
+		else if( ch == c_begin_tag )
+			return char_class_t::begin_tag;
+		else if( ch == c_end_tag )
+			return char_class_t::end_tag;
+		else if( ch == c_quotes )
+			return char_class_t::quotes;
+		else if( ch == c_back_slash )
+			return char_class_t::back_slash;
+		else if( ch == c_vertical_bar )
+			return char_class_t::vertical_bar;
+		else
+			return char_class_t::other;
+	}
+}; // struct const_chars_t
+
+template< typename Trait, typename Char >
+const Char const_chars_t< Trait, Char >::c_begin_tag =
+	Trait::from_ascii( '{' );
+
+template< typename Trait, typename Char >
+const Char const_chars_t< Trait, Char >::c_end_tag =
+	Trait::from_ascii( '}' );
+
+template< typename Trait, typename Char >
+const Char const_chars_t< Trait, Char >::c_quotes =
+	Trait::from_ascii( '"' );
+
+template< typename Trait, typename Char >
+const Char const_chars_t< Trait, Char >::c_n =
+	Trait::from_ascii( 'n' );
+
+template< typename Trait, typename Char >
+const Char const_chars_t< Trait, Char >::c_t =
+	Trait::from_ascii( 't' );
+
+template< typename Trait, typename Char >
+const Char const_chars_t< Trait, Char >::c_r =
+	Trait::from_ascii( 'r' );
+
+template< typename Trait, typename Char >
+const Char const_chars_t< Trait, Char >::c_back_slash =
+	Trait::from_ascii( '\\' );
+
+template< typename Trait, typename Char >
+const Char const_chars_t< Trait, Char >::c_space =
+	Trait::from_ascii( ' ' );
+
+template< typename Trait, typename Char >
+const Char const_chars_t< Trait, Char >::c_tab =
+	Trait::from_ascii( '\t' );
+
+template< typename Trait, typename Char >
+const Char const_chars_t< Trait, Char >::c_carriage_return =
+	Trait::from_ascii( '\n' );
+
+template< typename Trait, typename Char >
+const Char const_chars_t< Trait, Char >::c_line_feed =
+	Trait::from_ascii( '\r' );
+
+template< typename Trait, typename Char >
+const Char const_chars_t< Trait, Char >::c_vertical_bar =
+	Trait::from_ascii( '|' );
+
+template< typename Trait, typename Char >
+const Char const_chars_t< Trait, Char >::c_sharp =
+	Trait::from_ascii( '#' );
+
+
+//! Delimiters of the narrow strings, known at compile time.
 template< typename Trait >
-struct const_t {
-	static const typename Trait::char_t c_begin_tag;
-	static const typename Trait::char_t c_end_tag;
-	static const typename Trait::char_t c_quotes;
-	static const typename Trait::char_t c_n;
-	static const typename Trait::char_t c_t;
-	static const typename Trait::char_t c_r;
-	static const typename Trait::char_t c_back_slash;
-	static const typename Trait::char_t c_space;
-	static const typename Trait::char_t c_tab;
-	static const typename Trait::char_t c_carriage_return;
-	static const typename Trait::char_t c_line_feed;
-	static const typename Trait::char_t c_vertical_bar;
-	static const typename Trait::char_t c_sharp;
+struct const_chars_t< Trait, char > {
+	static constexpr char c_begin_tag = '{';
+	static constexpr char c_end_tag = '}';
+	static constexpr char c_quotes = '"';
+	static constexpr char c_n = 'n';
+	static constexpr char c_t = 't';
+	static constexpr char c_r = 'r';
+	static constexpr char c_back_slash = '\\';
+	static constexpr char c_space = ' ';
+	static constexpr char c_tab = '\t';
+	static constexpr char c_carriage_return = '\n';
+	static constexpr char c_line_feed = '\r';
+	static constexpr char c_vertical_bar = '|';
+	static constexpr char c_sharp = '#';
+
+	//! Classes of the characters.
+	static constexpr char_class_table_t c_char_classes = char_class_table_t();
+
+	//! \return Class of the \a ch.
+	static char_class_t char_class( char ch )
+	{
+		return c_char_classes[ static_cast< unsigned char > ( ch ) ];
+	}
+}; // struct const_chars_t< Trait, char >
 
-	static const typename Trait::string_t c_one_line_comment;
-	static const typename Trait::string_t c_start_multi_line_comment;
-	static const typename Trait::string_t c_finish_multi_line_comment;
+template< typename Trait >
+constexpr char const_chars_t< Trait, char >::c_begin_tag;
 
-	static const typename Trait::string_t c_on;
-	static const typename Trait::string_t c_off;
-	static const typename Trait::string_t c_true;
-	static const typename Trait::string_t c_false;
-	static const typename Trait::string_t c_1;
-	static const typename Trait::string_t c_0;
-	static const typename Trait::string_t c_yes;
-	static const typename Trait::string_t c_no;
-}; // struct const_t
+template< typename Trait >
+constexpr char const_chars_t< Trait, char >::c_end_tag;
 
 template< typename Trait >
-const typename Trait::char_t const_t< Trait >::c_begin_tag =
-	Trait::from_ascii( '{' );
+constexpr char const_chars_t< Trait, char >::c_quotes;
 
 template< typename Trait >
-const typename Trait::char_t const_t< Trait >::c_end_tag =
-	Trait::from_ascii( '}' );
+constexpr char const_chars_t< Trait, char >::c_n;
 
 template< typename Trait >
-const typename Trait::char_t const_t< Trait >::c_quotes =
-	Trait::from_ascii( '"' );
+constexpr char const_chars_t< Trait, char >::c_t;
 
 template< typename Trait >
-const typename Trait::char_t const_t< Trait >::c_n =
-	Trait::from_ascii( 'n' );
+constexpr char const_chars_t< Trait, char >::c_r;
 
 template< typename Trait >
-const typename Trait::char_t const_t< Trait >::c_t =
-	Trait::from_ascii( 't' );
+constexpr char const_chars_t< Trait, char >::c_back_slash;
 
 template< typename Trait >
-const typename Trait::char_t const_t< Trait >::c_r =
-	Trait::from_ascii( 'r' );
+constexpr char const_chars_t< Trait, char >::c_space;
 
 template< typename Trait >
-const typename Trait::char_t const_t< Trait >::c_back_slash =
-	Trait::from_ascii( '\\' );
+constexpr char const_chars_t< Trait, char >::c_tab;
 
 template< typename Trait >
-const typename Trait::char_t const_t< Trait >::c_space =
-	Trait::from_ascii( ' ' );
+constexpr char const_chars_t< Trait, char >::c_carriage_return;
 
 template< typename Trait >
-const typename Trait::char_t const_t< Trait >::c_tab =
-	Trait::from_ascii( '\t' );
+constexpr char const_chars_t< Trait, char >::c_line_feed;
 
 template< typename Trait >
-const typename Trait::char_t const_t< Trait >::c_carriage_return =
-	Trait::from_ascii( '\n' );
+constexpr char const_chars_t< Trait, char >::c_vertical_bar;
 
 template< typename Trait >
-const typename Trait::char_t const_t< Trait >::c_line_feed =
-	Trait::from_ascii( '\r' );
+constexpr char const_chars_t< Trait, char >::c_sharp;
 
 template< typename Trait >
-const typename Trait::char_t const_t< Trait >::c_vertical_bar =
-	Trait::from_ascii( '|' );
+constexpr char_class_table_t const_chars_t< Trait, char >::c_char_classes;
 
+
+//! Delimiters of the wide strings, known at compile time.
 template< typename Trait >
-const typename Trait::char_t const_t< Trait >::c_sharp =
-	Trait::from_ascii( '#' );
+struct const_chars_t< Trait, wchar_t > {
+	static constexpr wchar_t c_begin_tag = L'{';
+	static constexpr wchar_t c_end_tag = L'}';
+	static constexpr wchar_t c_quotes = L'"';
+	static constexpr wchar_t c_n = L'n';
+	static constexpr wchar_t c_t = L't';
+	static constexpr wchar_t c_r = L'r';
+	static constexpr wchar_t c_back_slash = L'\\';
+	static constexpr wchar_t c_space = L' ';
+	static constexpr wchar_t c_tab = L'\t';
+	static constexpr wchar_t c_carriage_return = L'\n';
+	static constexpr wchar_t c_line_feed = L'\r';
+	static constexpr wchar_t c_vertical_bar = L'|';
+	static constexpr wchar_t c_sharp = L'#';
+
+	//! Classes of the characters.
+	static constexpr char_class_table_t c_char_classes = char_class_table_t();
+
+	//! \return Class of the \a ch.
+	static char_class_t char_class( wchar_t ch )
+	{
+		const std::size_t code = static_cast< std::size_t > ( ch );
+
+		return ( code < 256 ? c_char_classes[ code ] : char_class_t::other );
+	}
+}; // struct const_chars_t< Trait, wchar_t >
+
+template< typename Trait >
+constexpr wchar_t const_chars_t< Trait, wchar_t >::c_begin_tag;
+
+template< typename Trait >
+constexpr wchar_t const_chars_t< Trait, wchar_t >::c_end_tag;
+
+template< typename Trait >
+constexpr wchar_t const_chars_t< Trait, wchar_t >::c_quotes;
+
+template< typename Trait >
+constexpr wchar_t const_chars_t< Trait, wchar_t >::c_n;
+
+template< typename Trait >
+constexpr wchar_t const_chars_t< Trait, wchar_t >::c_t;
+
+template< typename Trait >
+constexpr wchar_t const_chars_t< Trait, wchar_t >::c_r;
+
+template< typename Trait >
+constexpr wchar_t const_chars_t< Trait, wchar_t >::c_back_slash;
+
+template< typename Trait >
+constexpr wchar_t const_chars_t< Trait, wchar_t >::c_space;
+
+template< typename Trait >
+constexpr wchar_t const_chars_t< Trait, wchar_t >::c_tab;
+
+template< typename Trait >
+constexpr wchar_t const_chars_t< Trait, wchar_t >::c_carriage_return;
+
+template< typename Trait >
+constexpr wchar_t const_chars_t< Trait, wchar_t >::c_line_feed;
+
+template< typename Trait >
+constexpr wchar_t const_chars_t< Trait, wchar_t >::c_vertical_bar;
+
+template< typename Trait >
+constexpr wchar_t const_chars_t< Trait, wchar_t >::c_sharp;
+
+template< typename Trait >
+constexpr char_class_table_t const_chars_t< Trait, wchar_t >::c_char_classes;
+
+} /* namespace details */
+
+
+//
+// const_t
+//
+
+/*!
+	Constants of the cfgfile format.
+
+	Delimiters are constexpr for the narrow and the wide characters.
+*/
+template< typename Trait >
+struct const_t
+	:	public details::const_chars_t< Trait >
+{
+	static const typename Trait::string_t c_one_line_comment;
+	static const typename Trait::string_t c_start_multi_line_comment;
+	static const typename Trait::string_t c_finish_multi_line_comment;
+
+	static const typename Trait::string_t c_on;
+	static const typename Trait::string_t c_off;
+	static const typename Trait::string_t c_true;
+	static const typename Trait::string_t c_false;
+	static const typename Trait::string_t c_1;
+	static const typename Trait::string_t c_0;
+	static const typename Trait::string_t c_yes;
+	static const typename Trait::string_t c_no;
+}; // struct const_t
 
 template< typename Trait >
 const typename Trait::string_t const_t< Trait >::c_one_line_comment =
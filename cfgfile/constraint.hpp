@@ -34,6 +34,72 @@ public:
 	check( const T & value ) const = 0;
 }; // class constraint_t
 
+
+//
+// constraint_checker_t
+//
+
+/*!
+	Constraint of the tag's value.
+
+	It's either an object derived from constraint_t or a plain function.
+	Function is used by generated code, it doesn't require virtual call
+	and any construction per instance of the tag.
+*/
+template< class T >
+class constraint_checker_t final {
+public:
+	//! Type of the check function.
+	typedef bool (*check_func_t)( const T & );
+
+	constraint_checker_t()
+		:	m_constraint( nullptr )
+		,	m_func( nullptr )
+	{
+	}
+
+	//! Set constraint object.
+	void set( constraint_t< T > * c )
+	{
+		m_constraint = c;
+		m_func = nullptr;
+	}
+
+	//! Set check function.
+	void set( check_func_t f )
+	{
+		m_func = f;
+		m_constraint = nullptr;
+	}
+
+	//! \return Is any constraint set?
+	explicit operator bool () const
+	{
+		return ( m_func || m_constraint );
+	}
+
+	/*!
+		Check value for correctness.
+
+		\return Was check successful?
+	*/
+	bool check( const T & value ) const
+	{
+		if( m_func )
+			return m_func( value );
+		else if( m_constraint )
+			return m_constraint->check( value );
+		else
+			return true;
+	}
+
+private:
+	//! Constraint object.
+	constraint_t< T > * m_constraint;
+	//! Check function.
+	check_func_t m_func;
+}; // class constraint_checker_t
+
 } /* namespace cfgfile */
 
 #endif // CFGFILE__CONSTRAINT_HPP__INCLUDED
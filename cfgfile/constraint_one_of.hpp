@@ -11,7 +11,9 @@
 #include "constraint.hpp"
 
 // C++ include.
-#include <set>
+#include <vector>
+#include <algorithm>
+#include <initializer_list>
 
 
 namespace cfgfile {
@@ -20,7 +22,12 @@ namespace cfgfile {
 // constraint_one_of_t
 //
 
-//! Constraint that allowed values to be in the given list of values.
+/*!
+	Constraint that allowed values to be in the given list of values.
+
+	Values are kept in a sorted contiguous vector. Small lists are
+	checked with linear scan, bigger ones with binary search.
+*/
 template< class T >
 class constraint_one_of_t final
 	:	public constraint_t< T >
@@ -31,6 +38,17 @@ public:
 	{
 	}
 
+	//! Construct constraint with the given values.
+	constraint_one_of_t( std::initializer_list< T > values )
+		:	m_list( values )
+	{
+		std::sort( m_list.begin(), m_list.end() );
+
+		m_list.erase( std::unique( m_list.begin(), m_list.end(),
+			[] ( const T & a, const T & b ) { return !( a < b ) && !( b < a ); } ),
+			m_list.end() );
+	}
+
 	~constraint_one_of_t()
 	{
 	}
@@ -39,14 +57,20 @@ public:
 	void
 	add_value( const T & value )
 	{
-		m_list.insert( value );
+		const auto it = std::lower_bound( m_list.begin(), m_list.end(), value );
+
+		if( it == m_list.end() || value < *it )
+			m_list.insert( it, value );
 	}
 
 	//! Add value to the list of values of the constraint.
 	void
 	remove_value( const T & value )
 	{
-		m_list.erase( value );
+		const auto it = std::lower_bound( m_list.begin(), m_list.end(), value );
+
+		if( it != m_list.end() && !( value < *it ) )
+			m_list.erase( it );
 	}
 
 	/*!
@@ -58,12 +82,28 @@ public:
 	*/
 	bool check( const T & value ) const override
 	{
-		return ( m_list.find( value ) != m_list.cend() );
+		if( m_list.size() <= c_linear_search_max )
+		{
+			for( const T & v : m_list )
+			{
+				if( !( v < value ) && !( value < v ) )
+					return true;
+			}
+
+			return false;
+		}
+
+		const auto it = std::lower_bound( m_list.cbegin(), m_list.cend(), value );
+
+		return ( it != m_list.cend() && !( value < *it ) );
 	}
 
 private:
-	//! List of allowed values.
-	std::set< T > m_list;
+	//! Max size of the list when linear scan is used.
+	static const std::size_t c_linear_search_max = 8;
+
+	//! Sorted list of allowed values.
+	std::vector< T > m_list;
 }; // class constraint_one_of_t
 
 } /* namespace cfgfile */
@@ -0,0 +1,249 @@
+/*
+	SPDX-FileCopyrightText: 2017-2024 Igor Mironchik <igor.mironchik@gmail.com>
+	SPDX-License-Identifier: MIT
+*/
+
+#ifndef CFGFILE__DIFF_HPP__INCLUDED
+#define CFGFILE__DIFF_HPP__INCLUDED
+
+// cfgfile include.
+#include "types.hpp"
+#include "tag.hpp"
+
+// C++ include.
+#include <vector>
+
+
+namespace cfgfile {
+
+//
+// diff_kind_t
+//
+
+//! Kind of the difference between two trees of tags.
+enum class diff_kind_t {
+	//! Tag is defined only in the new tree.
+	added,
+	//! Tag is defined only in the old tree.
+	removed,
+	//! Values of the tag are different.
+	changed
+}; // enum class diff_kind_t
+
+
+//
+// diff_entry_t
+//
+
+//! Difference between two trees of tags.
+template< typename Trait = string_trait_t >
+struct diff_entry_t {
+	//! Kind of the difference.
+	diff_kind_t m_kind;
+	//! Path to the tag, i.e. "cfg.servers[1].port".
+	typename Trait::string_t m_path;
+	//! Values in the old tree, empty for added tag.
+	typename Trait::string_t m_old_values;
+	//! Values in the new tree, empty for removed tag.
+	typename Trait::string_t m_new_values;
+}; // struct diff_entry_t
+
+
+namespace details {
+
+//
+// tree_diff_t
+//
+
+//! Walks two trees of tags in parallel and collects the differences.
+template< typename Trait >
+class tree_diff_t final {
+public:
+	explicit tree_diff_t( std::vector< diff_entry_t< Trait > > & result )
+		:	m_result( result )
+	{
+	}
+
+	//! Compare the \a before and the \a after tags at the \a path.
+	void diff( const tag_t< Trait > & before, const tag_t< Trait > & after,
+		const typename Trait::string_t & path )
+	{
+		if( before.content_hash() == after.content_hash() )
+			return;
+
+		if( before.is_defined() && !after.is_defined() )
+		{
+			add( diff_kind_t::removed, path, before.print_values(),
+				typename Trait::string_t() );
+
+			return;
+		}
+		else if( !before.is_defined() && after.is_defined() )
+		{
+			add( diff_kind_t::added, path, typename Trait::string_t(),
+				after.print_values() );
+
+			return;
+		}
+		else if( !before.is_defined() )
+			return;
+
+		const typename Trait::string_t before_values = before.print_values();
+		const typename Trait::string_t after_values = after.print_values();
+
+		if( before_values != after_values )
+			add( diff_kind_t::changed, path, before_values, after_values );
+
+		diff_children( before, after, path );
+		diff_elements( before, after, path );
+	}
+
+private:
+	//! Compare children of the tags.
+	void diff_children( const tag_t< Trait > & before,
+		const tag_t< Trait > & after, const typename Trait::string_t & path )
+	{
+		const auto & before_children = before.children();
+		const auto & after_children = after.children();
+
+		for( std::size_t i = 0; i < before_children.size(); ++i )
+		{
+			const tag_t< Trait > * child = before_children[ i ];
+			const tag_t< Trait > * other = find( *child, after_children, i );
+
+			if( other )
+				diff( *child, *other, child_path( path, *child ) );
+			else if( child->is_defined() )
+				add( diff_kind_t::removed, child_path( path, *child ),
+					child->print_values(), typename Trait::string_t() );
+		}
+
+		for( std::size_t i = 0; i < after_children.size(); ++i )
+		{
+			const tag_t< Trait > * child = after_children[ i ];
+
+			if( !find( *child, before_children, i ) && child->is_defined() )
+				add( diff_kind_t::added, child_path( path, *child ),
+					typename Trait::string_t(), child->print_values() );
+		}
+	}
+
+	//! Compare repeated tags by index.
+	void diff_elements( const tag_t< Trait > & before,
+		const tag_t< Trait > & after, const typename Trait::string_t & path )
+	{
+		const std::size_t before_count = before.elements_count();
+		const std::size_t after_count = after.elements_count();
+
+		for( std::size_t i = 0; i < before_count || i < after_count; ++i )
+		{
+			const typename Trait::string_t p = element_path( path, i );
+
+			if( i < before_count && i < after_count )
+				diff( *before.element( i ), *after.element( i ), p );
+			else if( i < before_count )
+				add( diff_kind_t::removed, p, before.element( i )->print_values(),
+					typename Trait::string_t() );
+			else
+				add( diff_kind_t::added, p, typename Trait::string_t(),
+					after.element( i )->print_values() );
+		}
+	}
+
+	/*!
+		\return Tag with the same name as the \a tag in the \a list,
+		the \a hint is the index where it's expected.
+	*/
+	static const tag_t< Trait > * find( const tag_t< Trait > & tag,
+		const typename tag_t< Trait >::child_tags_list_t & list,
+		std::size_t hint )
+	{
+		if( hint < list.size() && list[ hint ]->has_same_name( tag ) )
+			return list[ hint ];
+
+		for( const tag_t< Trait > * t : list )
+		{
+			if( t->has_same_name( tag ) )
+				return t;
+		}
+
+		return nullptr;
+	}
+
+	//! \return Path of the \a child.
+	static typename Trait::string_t child_path(
+		const typename Trait::string_t & path, const tag_t< Trait > & child )
+	{
+		typename Trait::string_t result = path;
+
+		result.push_back( Trait::from_ascii( '.' ) );
+		result.append( child.name() );
+
+		return result;
+	}
+
+	//! \return Path of the repeated tag with the \a index.
+	static typename Trait::string_t element_path(
+		const typename Trait::string_t & path, std::size_t index )
+	{
+		typename Trait::string_t result = path;
+
+		result.push_back( Trait::from_ascii( '[' ) );
+		result.append( Trait::to_string(
+			static_cast< typename Trait::pos_t > ( index ) ) );
+		result.push_back( Trait::from_ascii( ']' ) );
+
+		return result;
+	}
+
+	//! Add difference.
+	void add( diff_kind_t kind, const typename Trait::string_t & path,
+		const typename Trait::string_t & old_values,
+		const typename Trait::string_t & new_values )
+	{
+		m_result.push_back( { kind, path, old_values, new_values } );
+	}
+
+private:
+	DISABLE_COPY( tree_diff_t )
+
+	//! Result.
+	std::vector< diff_entry_t< Trait > > & m_result;
+}; // class tree_diff_t
+
+} /* namespace details */
+
+
+//
+// diff
+//
+
+/*!
+	Compare two trees of tags.
+
+	Trees are walked in parallel, children are matched by name,
+	repeated tags of tag_vector_of_tags_t by index. Subtrees with equal
+	tag_t::content_hash() are skipped without walking into them.
+
+	\return Added, removed and changed tags with paths, empty if trees
+	are equal.
+*/
+template< typename Trait >
+static inline std::vector< diff_entry_t< Trait > > diff(
+	//! Old tree.
+	const tag_t< Trait > & before,
+	//! New tree.
+	const tag_t< Trait > & after )
+{
+	std::vector< diff_entry_t< Trait > > result;
+
+	details::tree_diff_t< Trait > d( result );
+
+	d.diff( before, after, before.name() );
+
+	return result;
+}
+
+} /* namespace cfgfile */
+
+#endif // CFGFILE__DIFF_HPP__INCLUDED
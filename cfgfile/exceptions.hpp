@@ -16,6 +16,363 @@
 
 namespace cfgfile {
 
+//
+// error_code_t
+//
+
+//! Code of the error.
+enum class error_code_t {
+	//! No error.
+	none,
+	//! Error with custom message.
+	custom,
+	//! Unrecognized back-slash sequence.
+	unrecognized_back_slash_sequence,
+	//! New line in quoted lexeme.
+	new_line_in_quoted_lexeme,
+	//! End of file in quoted lexeme.
+	end_of_file_in_quoted_lexeme,
+	//! End of file in back-slash sequence.
+	end_of_file_in_back_slash_sequence,
+	//! End of file while tag is unfinished.
+	unfinished_tag,
+	//! Mandatory tag is not defined.
+	undefined_mandatory_tag,
+	//! End of file instead of mandatory tag.
+	end_of_file_instead_of_mandatory_tag,
+	//! Content after the root tag.
+	unexpected_content,
+	//! Expected start curl brace.
+	expected_start_curl_brace,
+	//! Unexpected name of the tag.
+	unexpected_tag_name,
+	//! Unexpected name of the child tag.
+	unexpected_child_tag_name,
+	//! Start curl brace instead of tag name.
+	unexpected_start_curl_brace,
+	//! Finish curl brace instead of tag name.
+	unexpected_finish_curl_brace,
+	//! End of file instead of tag name.
+	unexpected_end_of_file,
+	//! Value can't be converted.
+	invalid_value,
+	//! Value doesn't match to the constraint.
+	value_does_not_match_constraint,
+	//! Value after child tag.
+	value_after_child_tag,
+	//! Value already defined.
+	value_already_defined,
+	//! Tag doesn't allow values.
+	value_is_not_allowed,
+	//! Value of the tag is not defined.
+	undefined_value,
+	//! Mandatory child tag is not defined.
+	undefined_child_mandatory_tag,
+	//! Limit of the parsing is exceeded, token is the name of the limit.
+	limit_exceeded
+}; // enum class error_code_t
+
+
+namespace details {
+
+//
+// error_t
+//
+
+/*!
+	Structured error.
+
+	Message is formatted once on construction by the cold format(),
+	so a shared constant error can be read from many threads.
+*/
+template< typename Trait >
+class error_t {
+public:
+	//! No error.
+	error_t()
+		:	m_code( error_code_t::none )
+		,	m_line_number( 0 )
+		,	m_column_number( 0 )
+	{
+	}
+
+	explicit error_t( typename Trait::string_t what )
+		:	m_code( error_code_t::custom )
+		,	m_line_number( 0 )
+		,	m_column_number( 0 )
+		,	m_what( std::move( what ) )
+	{
+	}
+
+	error_t( error_code_t code,
+		typename Trait::string_t file_name,
+		typename Trait::pos_t line_number,
+		typename Trait::pos_t column_number,
+		typename Trait::string_t tag_name,
+		typename Trait::string_t token )
+		:	m_code( code )
+		,	m_file_name( std::move( file_name ) )
+		,	m_line_number( line_number )
+		,	m_column_number( column_number )
+		,	m_tag_name( std::move( tag_name ) )
+		,	m_token( std::move( token ) )
+		,	m_what( format() )
+	{
+	}
+
+	//! \return Code of the error.
+	error_code_t code() const noexcept
+	{
+		return m_code;
+	}
+
+	//! \return File name.
+	const typename Trait::string_t & file_name() const noexcept
+	{
+		return m_file_name;
+	}
+
+	//! \return Line number.
+	typename Trait::pos_t line_number() const noexcept
+	{
+		return m_line_number;
+	}
+
+	//! \return Column number.
+	typename Trait::pos_t column_number() const noexcept
+	{
+		return m_column_number;
+	}
+
+	//! \return Name of the tag.
+	const typename Trait::string_t & tag_name() const noexcept
+	{
+		return m_tag_name;
+	}
+
+	//! \return Token, i.e. value or name, that caused the error.
+	const typename Trait::string_t & token() const noexcept
+	{
+		return m_token;
+	}
+
+	//! \return Reason of the exception.
+	const typename Trait::string_t & desc() const noexcept
+	{
+		return m_what;
+	}
+
+private:
+	//! \return Quoted string.
+	static typename Trait::string_t quoted( const typename Trait::string_t & str )
+	{
+		return Trait::from_ascii( "\"" ) + str + Trait::from_ascii( "\"" );
+	}
+
+	//! \return Formatted message.
+	CFGFILE_COLD typename Trait::string_t format() const
+	{
+		typename Trait::string_t msg;
+		bool with_position = true;
+
+		switch( m_code )
+		{
+			case error_code_t::unrecognized_back_slash_sequence :
+				msg = Trait::from_ascii( "Unrecognized back-slash sequence: \"\\" ) +
+					m_token + Trait::from_ascii( "\"." );
+				break;
+
+			case error_code_t::new_line_in_quoted_lexeme :
+				msg = Trait::from_ascii( "Unfinished quoted lexeme. "
+					"New line detected." );
+				break;
+
+			case error_code_t::end_of_file_in_quoted_lexeme :
+				msg = Trait::from_ascii( "Unfinished quoted lexeme. "
+					"End of file riched." );
+				break;
+
+			case error_code_t::end_of_file_in_back_slash_sequence :
+				msg = Trait::from_ascii( "Unexpected end of file. "
+					"Unfinished back slash sequence." );
+				break;
+
+			case error_code_t::unfinished_tag :
+				msg = Trait::from_ascii( "Unexpected end of file. "
+					"Still unfinished tag " ) + quoted( m_tag_name ) +
+					Trait::from_ascii( "." );
+				with_position = false;
+				break;
+
+			case error_code_t::undefined_mandatory_tag :
+				msg = Trait::from_ascii( "Undefined mandatory tag: " ) +
+					quoted( m_tag_name ) + Trait::from_ascii( "." );
+				with_position = false;
+				break;
+
+			case error_code_t::end_of_file_instead_of_mandatory_tag :
+				msg = Trait::from_ascii( "Unexpected end of file. "
+					"Undefined mandatory tag " ) + quoted( m_tag_name ) +
+					Trait::from_ascii( "." );
+				break;
+
+			case error_code_t::unexpected_content :
+				msg = Trait::from_ascii( "Unexpected content. "
+					"We've finished parsing, but we've got this: " ) +
+					quoted( m_token ) + Trait::from_ascii( "." );
+				break;
+
+			case error_code_t::expected_start_curl_brace :
+				msg = Trait::from_ascii( "Expected start curl brace, "
+					"but we've got " ) + quoted( m_token ) +
+					Trait::from_ascii( "." );
+				break;
+
+			case error_code_t::unexpected_tag_name :
+				msg = Trait::from_ascii( "Unexpected tag name. We expected " ) +
+					quoted( m_tag_name ) +
+					Trait::from_ascii( ", but we've got " ) +
+					quoted( m_token ) + Trait::from_ascii( "." );
+				break;
+
+			case error_code_t::unexpected_child_tag_name :
+				msg = Trait::from_ascii( "Unexpected tag name. "
+					"We expected one child tag of tag " ) + quoted( m_tag_name ) +
+					Trait::from_ascii( ", but we've got " ) +
+					quoted( m_token ) + Trait::from_ascii( "." );
+				break;
+
+			case error_code_t::unexpected_start_curl_brace :
+				msg = Trait::from_ascii( "Unexpected start curl brace. "
+					"We expected tag name, but we've got start curl brace." );
+				break;
+
+			case error_code_t::unexpected_finish_curl_brace :
+				msg = Trait::from_ascii( "Unexpected finish curl brace. "
+					"We expected tag name, but we've got finish curl brace." );
+				break;
+
+			case error_code_t::unexpected_end_of_file :
+				msg = Trait::from_ascii( "Unexpected end of file." );
+				break;
+
+			case error_code_t::invalid_value :
+				msg = Trait::from_ascii( "Invalid value: " ) +
+					quoted( m_token ) + Trait::from_ascii( "." );
+				break;
+
+			case error_code_t::value_does_not_match_constraint :
+				msg = Trait::from_ascii( "Invalid value: " ) +
+					quoted( m_token ) +
+					Trait::from_ascii( ". Value must match to the "
+						"constraint in tag " ) +
+					quoted( m_tag_name ) + Trait::from_ascii( "." );
+				break;
+
+			case error_code_t::value_after_child_tag :
+				msg = Trait::from_ascii( "Value " ) + quoted( m_token ) +
+					Trait::from_ascii( " for tag " ) + quoted( m_tag_name ) +
+					Trait::from_ascii( " must be defined before any child tag." );
+				break;
+
+			case error_code_t::value_already_defined :
+				msg = Trait::from_ascii( "Value for the tag " ) +
+					quoted( m_tag_name ) +
+					Trait::from_ascii( " already defined." );
+				break;
+
+			case error_code_t::value_is_not_allowed :
+				msg = Trait::from_ascii( "Tag " ) + quoted( m_tag_name ) +
+					Trait::from_ascii( " doesn't allow any values. "
+						"But we've got this: " ) +
+					quoted( m_token ) + Trait::from_ascii( "." );
+				break;
+
+			case error_code_t::undefined_value :
+				msg = Trait::from_ascii( "Undefined value of tag: " ) +
+					quoted( m_tag_name ) + Trait::from_ascii( "." );
+				break;
+
+			case error_code_t::undefined_child_mandatory_tag :
+				msg = Trait::from_ascii( "Undefined child mandatory tag: " ) +
+					quoted( m_token ) +
+					Trait::from_ascii( ". Where parent is: " ) +
+					quoted( m_tag_name ) + Trait::from_ascii( "." );
+				break;
+
+			case error_code_t::limit_exceeded :
+				msg = Trait::from_ascii( "Limit " ) + quoted( m_token ) +
+					Trait::from_ascii( " exceeded." );
+				break;
+
+			default :
+				with_position = false;
+				break;
+		}
+
+		if( with_position )
+			msg = msg + Trait::from_ascii( " In file " ) + quoted( m_file_name ) +
+				Trait::from_ascii( " on line " ) +
+				Trait::to_string( m_line_number ) + Trait::from_ascii( "." );
+
+		return msg;
+	}
+
+private:
+	//! Code of the error.
+	error_code_t m_code;
+	//! File name.
+	typename Trait::string_t m_file_name;
+	//! Line number.
+	typename Trait::pos_t m_line_number;
+	//! Column number.
+	typename Trait::pos_t m_column_number;
+	//! Name of the tag.
+	typename Trait::string_t m_tag_name;
+	//! Token.
+	typename Trait::string_t m_token;
+	//! Reason of the exception.
+	typename Trait::string_t m_what;
+}; // class error_t
+
+} /* namespace details */
+
+
+//
+// parse_result_t
+//
+
+//! Result of parsing reported without exceptions.
+template< typename Trait = string_trait_t >
+class parse_result_t final
+	:	public details::error_t< Trait >
+{
+public:
+	//! Successful result.
+	parse_result_t()
+	{
+	}
+
+	//! Failed result.
+	explicit parse_result_t( const details::error_t< Trait > & error )
+		:	details::error_t< Trait >( error )
+	{
+	}
+
+	//! \return Was parsing successful?
+	bool ok() const noexcept
+	{
+		return ( this->code() == error_code_t::none );
+	}
+
+	//! \return Was parsing successful?
+	explicit operator bool () const noexcept
+	{
+		return ok();
+	}
+}; // class parse_result_t
+
+
 //
 // exception_t
 //
@@ -24,28 +381,33 @@ namespace cfgfile {
 template< typename Trait = string_trait_t >
 class exception_t final
 	:	public std::logic_error
+	,	public details::error_t< Trait >
 {
 public:
 	//! Construct exception.
 	explicit exception_t( typename Trait::string_t what )
 		:	std::logic_error( "Please use desc() method of the exception." )
-		,	m_what( std::move( what ) )
+		,	details::error_t< Trait >( std::move( what ) )
 	{
 	}
 
-	~exception_t() noexcept
+	//! Construct exception with message formatted from the error code.
+	exception_t( error_code_t code,
+		typename Trait::string_t file_name,
+		typename Trait::pos_t line_number,
+		typename Trait::pos_t column_number,
+		typename Trait::string_t tag_name = typename Trait::string_t(),
+		typename Trait::string_t token = typename Trait::string_t() )
+		:	std::logic_error( "Please use desc() method of the exception." )
+		,	details::error_t< Trait >( code, std::move( file_name ),
+				line_number, column_number, std::move( tag_name ),
+				std::move( token ) )
 	{
 	}
 
-	//! \return Reason of the exception.
-	const typename Trait::string_t & desc() const noexcept
+	~exception_t() noexcept
 	{
-		return m_what;
 	}
-
-private:
-	//! Reason of the exception.
-	typename Trait::string_t m_what;
 }; // class exception_t
 
 
@@ -58,12 +420,27 @@ private:
 template<>
 class exception_t< string_trait_t >
 	:	public std::logic_error
+	,	public details::error_t< string_trait_t >
 {
 public:
 	//! Construct exception.
 	explicit exception_t( string_trait_t::string_t what )
 		:	std::logic_error( what )
-		,	m_what( std::move( what ) )
+		,	details::error_t< string_trait_t >( std::move( what ) )
+	{
+	}
+
+	//! Construct exception with message formatted from the error code.
+	exception_t( error_code_t code,
+		string_trait_t::string_t file_name,
+		string_trait_t::pos_t line_number,
+		string_trait_t::pos_t column_number,
+		string_trait_t::string_t tag_name = string_trait_t::string_t(),
+		string_trait_t::string_t token = string_trait_t::string_t() )
+		:	std::logic_error( "" )
+		,	details::error_t< string_trait_t >( code, std::move( file_name ),
+				line_number, column_number, std::move( tag_name ),
+				std::move( token ) )
 	{
 	}
 
@@ -72,18 +449,45 @@ public:
 	}
 
 	//! \return Reason of the exception.
-	const string_trait_t::string_t & desc() const noexcept
+	const char * what() const noexcept override
 	{
-		return m_what;
+		return desc().c_str();
 	}
-
-private:
-	//! Reason of the exception.
-	string_trait_t::string_t m_what;
 }; // class exception_t< string_trait_t >
 
 #endif // CFGFILE_DISABLE_STL
 
+
+namespace details {
+
+//
+// throw_error
+//
+
+//! Throw exception_t without position.
+template< typename Trait >
+[[noreturn]] CFGFILE_COLD void throw_error( error_code_t code,
+	const typename Trait::string_t & tag_name )
+{
+	throw exception_t< Trait >( code, typename Trait::string_t(), 0, 0,
+		tag_name );
+}
+
+//! Throw exception_t with position.
+template< typename Trait >
+[[noreturn]] CFGFILE_COLD void throw_error( error_code_t code,
+	const typename Trait::string_t & file_name,
+	typename Trait::pos_t line_number,
+	typename Trait::pos_t column_number,
+	const typename Trait::string_t & tag_name = typename Trait::string_t(),
+	const typename Trait::string_t & token = typename Trait::string_t() )
+{
+	throw exception_t< Trait >( code, file_name, line_number, column_number,
+		tag_name, token );
+}
+
+} /* namespace details */
+
 } /* namespace cfgfile */
 
 #endif // CFGFILE__EXCEPTIONS_HPP__INCLUDED
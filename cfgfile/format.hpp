@@ -16,6 +16,18 @@
 // C++ include.
 #include <limits>
 
+#ifndef CFGFILE_DISABLE_STL
+#include <cerrno>
+#include <clocale>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cwchar>
+#include <string>
+#include <type_traits>
+#endif
+
 #ifdef CFGFILE_QT_SUPPORT
 // Qt include.
 #include <QString>
@@ -35,7 +47,15 @@ public:
 	//! Format value to string.
 	static typename Trait::string_t to_string( const T & );
 
-	//! Format value from string.
+	/*!
+		Format value from string.
+
+		Built-in formats report invalid value with details::report_error().
+		Without error sink in the source of the info it throws
+		exception_t< Trait >. While try_parse() the error is stored in the
+		sink and a default value is returned, so a caller that uses the
+		result with such info must check parser_info_t::has_error() first.
+	*/
 	static T from_string( const parser_info_t< Trait > &,
 		const typename Trait::string_t & );
 }; // class format_t
@@ -43,6 +63,325 @@ public:
 
 #ifndef CFGFILE_DISABLE_STL
 
+namespace details {
+
+//! \return Decimal point of the current C locale.
+inline char locale_decimal_point()
+{
+	const char * point = std::localeconv()->decimal_point;
+
+	return ( point && *point ? *point : '.' );
+}
+
+//! \return Is \a ch a decimal digit.
+template< typename Char >
+inline bool is_decimal_digit( Char ch )
+{
+	return ( ch >= Char( '0' ) && ch <= Char( '9' ) );
+}
+
+/*!
+	Parse double with strtod() independently of the C locale.
+
+	\return false if [first, last) is not a number or overflows.
+*/
+template< typename Char >
+bool strtod_double( const Char * first, const Char * last, double & result )
+{
+	using uchar_t = typename std::make_unsigned< Char >::type;
+
+	const char point = locale_decimal_point();
+
+	std::string buf;
+	buf.reserve( static_cast< std::size_t > ( last - first ) );
+
+	for( ; first != last; ++first )
+	{
+		if( static_cast< uchar_t > ( *first ) > 127u )
+			return false;
+
+		const char ch = static_cast< char > ( *first );
+
+		buf.push_back( ch == '.' ? point : ch );
+	}
+
+	if( buf.empty() )
+		return false;
+
+	char * end = nullptr;
+	errno = 0;
+
+	result = std::strtod( buf.c_str(), &end );
+
+	if( errno == ERANGE && std::fabs( result ) == HUGE_VAL )
+		return false;
+
+	return ( end == buf.c_str() + buf.size() );
+}
+
+/*!
+	Parse double from [first, last).
+
+	Numbers with at most 2^53 as the significand and decimal exponent
+	within [-22, 22], which are the most of numbers in configuration
+	files, are computed exactly with one multiplication or division.
+	Everything else goes to strtod_double().
+
+	\return false if [first, last) is not a number.
+*/
+template< typename Char >
+bool parse_double( const Char * first, const Char * last, double & result )
+{
+	static const double powers_of_ten[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	const Char * p = first;
+	bool negative = false;
+
+	if( p != last && ( *p == Char( '-' ) || *p == Char( '+' ) ) )
+	{
+		negative = ( *p == Char( '-' ) );
+		++p;
+	}
+
+	std::uint64_t mantissa = 0;
+	int digits = 0;
+	int exponent = 0;
+	bool any_digit = false;
+	bool truncated = false;
+
+	for( ; p != last && is_decimal_digit( *p ); ++p )
+	{
+		any_digit = true;
+
+		if( digits < 19 )
+		{
+			mantissa = mantissa * 10 + static_cast< unsigned > ( *p - Char( '0' ) );
+
+			if( mantissa != 0 )
+				++digits;
+		}
+		else
+		{
+			truncated = true;
+			++exponent;
+		}
+	}
+
+	if( p != last && *p == Char( '.' ) )
+	{
+		for( ++p; p != last && is_decimal_digit( *p ); ++p )
+		{
+			any_digit = true;
+
+			if( digits < 19 )
+			{
+				mantissa = mantissa * 10 + static_cast< unsigned > ( *p - Char( '0' ) );
+				--exponent;
+
+				if( mantissa != 0 )
+					++digits;
+			}
+			else
+				truncated = true;
+		}
+	}
+
+	// inf, nan, hexadecimal and so on.
+	if( !any_digit )
+		return strtod_double( first, last, result );
+
+	if( p != last && ( *p == Char( 'e' ) || *p == Char( 'E' ) ) )
+	{
+		++p;
+
+		bool negative_exponent = false;
+
+		if( p != last && ( *p == Char( '-' ) || *p == Char( '+' ) ) )
+		{
+			negative_exponent = ( *p == Char( '-' ) );
+			++p;
+		}
+
+		if( p == last || !is_decimal_digit( *p ) )
+			return false;
+
+		int e = 0;
+
+		for( ; p != last && is_decimal_digit( *p ); ++p )
+		{
+			if( e < 100000 )
+				e = e * 10 + static_cast< int > ( *p - Char( '0' ) );
+		}
+
+		exponent += ( negative_exponent ? -e : e );
+	}
+
+	if( p != last )
+		return strtod_double( first, last, result );
+
+	if( mantissa == 0 )
+	{
+		result = ( negative ? -0.0 : 0.0 );
+
+		return true;
+	}
+
+	if( !truncated && mantissa <= ( std::uint64_t( 1 ) << 53 ) &&
+		exponent >= -22 && exponent <= 22 )
+	{
+		double value = static_cast< double > ( mantissa );
+
+		if( exponent < 0 )
+			value /= powers_of_ten[ -exponent ];
+		else
+			value *= powers_of_ten[ exponent ];
+
+		result = ( negative ? -value : value );
+
+		return true;
+	}
+
+	return strtod_double( first, last, result );
+}
+
+/*!
+	\return String that reads back to the same \a value.
+
+	Integral values are printed as integers, others with the first of
+	%.15g, %.16g and %.17g that reads back to the same \a value. It's
+	not always the shortest such string, e.g. 5e-324 is printed as
+	4.94065645841247e-324. Decimal point is always '.' whatever the
+	C locale is.
+*/
+inline std::string double_to_string( double value )
+{
+	if( value == std::floor( value ) && std::fabs( value ) < 9007199254740992.0 &&
+		( value != 0.0 || !std::signbit( value ) ) )
+			return std::to_string( static_cast< long long > ( value ) );
+
+	char buf[ 32 ];
+
+	// Any 15 digits number survives round trip through double,
+	// 17 digits are always enough.
+	for( int precision = 15; precision <= 17; ++precision )
+	{
+		std::snprintf( buf, sizeof( buf ), "%.*g", precision, value );
+
+		if( std::strtod( buf, nullptr ) == value )
+			break;
+	}
+
+	const char point = locale_decimal_point();
+
+	std::string res( buf );
+
+	if( point != '.' )
+	{
+		for( auto & ch : res )
+		{
+			if( ch == point )
+				ch = '.';
+		}
+	}
+
+	return res;
+}
+
+//! std::strtol() and friends selected by the type of the result.
+inline long strto_integer( const char * str, char ** end, long )
+{
+	return std::strtol( str, end, 10 );
+}
+
+inline unsigned long strto_integer( const char * str, char ** end,
+	unsigned long )
+{
+	return std::strtoul( str, end, 10 );
+}
+
+inline long long strto_integer( const char * str, char ** end, long long )
+{
+	return std::strtoll( str, end, 10 );
+}
+
+inline unsigned long long strto_integer( const char * str, char ** end,
+	unsigned long long )
+{
+	return std::strtoull( str, end, 10 );
+}
+
+inline long strto_integer( const wchar_t * str, wchar_t ** end, long )
+{
+	return std::wcstol( str, end, 10 );
+}
+
+inline unsigned long strto_integer( const wchar_t * str, wchar_t ** end,
+	unsigned long )
+{
+	return std::wcstoul( str, end, 10 );
+}
+
+inline long long strto_integer( const wchar_t * str, wchar_t ** end,
+	long long )
+{
+	return std::wcstoll( str, end, 10 );
+}
+
+inline unsigned long long strto_integer( const wchar_t * str, wchar_t ** end,
+	unsigned long long )
+{
+	return std::wcstoull( str, end, 10 );
+}
+
+//! Type of std::strtol() and friends to parse \a Int.
+template< typename Int >
+struct strto_type_t {
+	using type = Int;
+};
+
+template<>
+struct strto_type_t< int > {
+	using type = long;
+};
+
+template<>
+struct strto_type_t< unsigned int > {
+	using type = unsigned long;
+};
+
+/*!
+	Parse integer as std::stoi() and friends do, but without exceptions.
+
+	\return false if \a value is not a number or out of range of \a Int.
+*/
+template< typename Char, typename Int >
+bool parse_integer( const std::basic_string< Char > & value, Int & result )
+{
+	using Wide = typename strto_type_t< Int >::type;
+
+	if( value.empty() )
+		return false;
+
+	Char * end = nullptr;
+	errno = 0;
+
+	const Wide wide = strto_integer( value.c_str(), &end, Wide() );
+
+	if( errno == ERANGE || end != value.c_str() + value.size() ||
+		wide < static_cast< Wide > ( std::numeric_limits< Int >::min() ) ||
+		wide > static_cast< Wide > ( std::numeric_limits< Int >::max() ) )
+			return false;
+
+	result = static_cast< Int > ( wide );
+
+	return true;
+}
+
+} /* namespace details */
+
 template<>
 class format_t< int, string_trait_t > {
 public:
@@ -56,31 +395,13 @@ public:
 	static int from_string( const parser_info_t< string_trait_t > & info,
 		const string_trait_t::string_t & value )
 	{
-		try {
-			std::size_t pos = 0;
-
-			int result = std::stoi( value, &pos );
+		int result = 0;
 
-			if( pos != value.length() )
-				throw exception_t< string_trait_t >(
-					string_trait_t::from_ascii( "Invalid value: \"" ) +
-					value + string_trait_t::from_ascii( "\". In file \"" ) +
-					info.file_name() +
-					string_trait_t::from_ascii( "\" on line " ) +
-					string_trait_t::to_string( info.line_number() ) +
-					string_trait_t::from_ascii( "." ) );
+		if( !details::parse_integer( value, result ) )
+			details::report_error( info, error_code_t::invalid_value,
+				string_trait_t::string_t(), value );
 
-			return result;
-		}
-		catch( const std::exception & )
-		{
-			throw exception_t< string_trait_t >(
-				string_trait_t::from_ascii( "Invalid value: \"" ) +
-				value + string_trait_t::from_ascii( "\". In file \"" ) +
-				info.file_name() + string_trait_t::from_ascii( "\" on line " ) +
-				string_trait_t::to_string( info.line_number() ) +
-				string_trait_t::from_ascii( "." ) );
-		}
+		return result;
 	}
 }; // class format_t< int >
 
@@ -98,32 +419,13 @@ public:
 	static int from_string( const parser_info_t< wstring_trait_t > & info,
 		const wstring_trait_t::string_t & value )
 	{
-		try {
-			std::size_t pos = 0;
-
-			int result = std::stoi( value, &pos );
+		int result = 0;
 
-			if( pos != value.length() )
-				throw exception_t< wstring_trait_t >(
-					wstring_trait_t::from_ascii( "Invalid value: \"" ) +
-					value + wstring_trait_t::from_ascii( "\". In file \"" ) +
-					info.file_name() +
-					wstring_trait_t::from_ascii( "\" on line " ) +
-					wstring_trait_t::to_string( info.line_number() ) +
-					wstring_trait_t::from_ascii( "." ) );
+		if( !details::parse_integer( value, result ) )
+			details::report_error( info, error_code_t::invalid_value,
+				wstring_trait_t::string_t(), value );
 
-			return result;
-		}
-		catch( const std::exception & )
-		{
-			throw exception_t< wstring_trait_t >(
-				wstring_trait_t::from_ascii( "Invalid value: \"" ) +
-				value + wstring_trait_t::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				wstring_trait_t::from_ascii( "\" on line " ) +
-				wstring_trait_t::to_string( info.line_number() ) +
-				wstring_trait_t::from_ascii( "." ) );
-		}
+		return result;
 	}
 }; // class format_t< int >
 
@@ -148,15 +450,10 @@ public:
 		int result = ((QString)value).toInt( &ok );
 
 		if( !ok )
-			throw exception_t< qstring_trait_t >(
-				qstring_trait_t::from_ascii( "Invalid value: \"" ) +
-				value + qstring_trait_t::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				qstring_trait_t::from_ascii( "\" on line " ) +
-				qstring_trait_t::to_string( info.line_number() ) +
-				qstring_trait_t::from_ascii( "." ) );
-		else
-			return result;
+			details::report_error( info, error_code_t::invalid_value,
+				qstring_trait_t::string_t(), value );
+
+		return result;
 	}
 }; // class format_t< int >
 #endif // CFGFILE_QT_SUPPORT
@@ -177,33 +474,13 @@ public:
 	static unsigned int from_string( const parser_info_t< string_trait_t > & info,
 		const string_trait_t::string_t & value )
 	{
-		try {
-			std::size_t pos = 0;
+		unsigned int result = 0;
 
-			unsigned long result = std::stoul( value, &pos );
+		if( !details::parse_integer( value, result ) )
+			details::report_error( info, error_code_t::invalid_value,
+				string_trait_t::string_t(), value );
 
-			if( pos != value.length() ||
-				result > std::numeric_limits< unsigned int >::max() )
-					throw exception_t< string_trait_t >(
-						string_trait_t::from_ascii( "Invalid value: \"" ) +
-						value + string_trait_t::from_ascii( "\". In file \"" ) +
-						info.file_name() +
-						string_trait_t::from_ascii( "\" on line " ) +
-						string_trait_t::to_string( info.line_number() ) +
-						string_trait_t::from_ascii( "." ) );
-
-			return (unsigned int) result;
-		}
-		catch( const std::exception & )
-		{
-			throw exception_t< string_trait_t >(
-				string_trait_t::from_ascii( "Invalid value: \"" ) +
-				value + string_trait_t::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				string_trait_t::from_ascii( "\" on line " ) +
-				string_trait_t::to_string( info.line_number() ) +
-				string_trait_t::from_ascii( "." ) );
-		}
+		return result;
 	}
 }; // class format_t< unsigned int >
 
@@ -221,33 +498,13 @@ public:
 	static unsigned int from_string( const parser_info_t< wstring_trait_t > & info,
 		const wstring_trait_t::string_t & value )
 	{
-		try {
-			std::size_t pos = 0;
-
-			unsigned long result = std::stoul( value, &pos );
+		unsigned int result = 0;
 
-			if( pos != value.length() ||
-				result > std::numeric_limits< unsigned int >::max() )
-					throw exception_t< wstring_trait_t >(
-						wstring_trait_t::from_ascii( "Invalid value: \"" ) +
-						value + wstring_trait_t::from_ascii( "\". In file \"" ) +
-						info.file_name() +
-						wstring_trait_t::from_ascii( "\" on line " ) +
-						wstring_trait_t::to_string( info.line_number() ) +
-						wstring_trait_t::from_ascii( "." ) );
+		if( !details::parse_integer( value, result ) )
+			details::report_error( info, error_code_t::invalid_value,
+				wstring_trait_t::string_t(), value );
 
-			return (unsigned int) result;
-		}
-		catch( const std::exception & )
-		{
-			throw exception_t< wstring_trait_t >(
-				wstring_trait_t::from_ascii( "Invalid value: \"" ) +
-				value + wstring_trait_t::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				wstring_trait_t::from_ascii( "\" on line " ) +
-				wstring_trait_t::to_string( info.line_number() ) +
-				wstring_trait_t::from_ascii( "." ) );
-		}
+		return result;
 	}
 }; // class format_t< unsigned int >
 
@@ -272,15 +529,10 @@ public:
 		unsigned int result = ((QString)value).toUInt( &ok );
 
 		if( !ok )
-			throw exception_t< qstring_trait_t >(
-				qstring_trait_t::from_ascii( "Invalid value: \"" ) +
-				value + qstring_trait_t::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				qstring_trait_t::from_ascii( "\" on line " ) +
-				qstring_trait_t::to_string( info.line_number() ) +
-				qstring_trait_t::from_ascii( "." ) );
-		else
-			return result;
+			details::report_error( info, error_code_t::invalid_value,
+				qstring_trait_t::string_t(), value );
+
+		return result;
 	}
 }; // class format_t< unsigned int >
 #endif // CFGFILE_QT_SUPPORT
@@ -301,32 +553,13 @@ public:
 	static long from_string( const parser_info_t< string_trait_t > & info,
 		const string_trait_t::string_t & value )
 	{
-		try {
-			std::size_t pos = 0;
-
-			long result = std::stol( value, &pos );
+		long result = 0;
 
-			if( pos != value.length() )
-				throw exception_t< string_trait_t >(
-					string_trait_t::from_ascii( "Invalid value: \"" ) +
-					value + string_trait_t::from_ascii( "\". In file \"" ) +
-					info.file_name() +
-					string_trait_t::from_ascii( "\" on line " ) +
-					string_trait_t::to_string( info.line_number() ) +
-					string_trait_t::from_ascii( "." ) );
+		if( !details::parse_integer( value, result ) )
+			details::report_error( info, error_code_t::invalid_value,
+				string_trait_t::string_t(), value );
 
-			return result;
-		}
-		catch( const std::exception & )
-		{
-			throw exception_t< string_trait_t >(
-				string_trait_t::from_ascii( "Invalid value: \"" ) +
-				value + string_trait_t::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				string_trait_t::from_ascii( "\" on line " ) +
-				string_trait_t::to_string( info.line_number() ) +
-				string_trait_t::from_ascii( "." ) );
-		}
+		return result;
 	}
 }; // class format_t< long >
 
@@ -344,32 +577,13 @@ public:
 	static long from_string( const parser_info_t< wstring_trait_t > & info,
 		const wstring_trait_t::string_t & value )
 	{
-		try {
-			std::size_t pos = 0;
+		long result = 0;
 
-			long result = std::stol( value, &pos );
+		if( !details::parse_integer( value, result ) )
+			details::report_error( info, error_code_t::invalid_value,
+				wstring_trait_t::string_t(), value );
 
-			if( pos != value.length() )
-				throw exception_t< wstring_trait_t >(
-					wstring_trait_t::from_ascii( "Invalid value: \"" ) +
-					value + wstring_trait_t::from_ascii( "\". In file \"" ) +
-					info.file_name() +
-					wstring_trait_t::from_ascii( "\" on line " ) +
-					wstring_trait_t::to_string( info.line_number() ) +
-					wstring_trait_t::from_ascii( "." ) );
-
-			return result;
-		}
-		catch( const std::exception & )
-		{
-			throw exception_t< wstring_trait_t >(
-				wstring_trait_t::from_ascii( "Invalid value: \"" ) +
-				value + wstring_trait_t::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				wstring_trait_t::from_ascii( "\" on line " ) +
-				wstring_trait_t::to_string( info.line_number() ) +
-				wstring_trait_t::from_ascii( "." ) );
-		}
+		return result;
 	}
 }; // class format_t< long >
 
@@ -394,15 +608,10 @@ public:
 		long result = ((QString)value).toLong( &ok );
 
 		if( !ok )
-			throw exception_t< qstring_trait_t >(
-				qstring_trait_t::from_ascii( "Invalid value: \"" ) +
-				value + qstring_trait_t::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				qstring_trait_t::from_ascii( "\" on line " ) +
-				qstring_trait_t::to_string( info.line_number() ) +
-				qstring_trait_t::from_ascii( "." ) );
-		else
-			return result;
+			details::report_error( info, error_code_t::invalid_value,
+				qstring_trait_t::string_t(), value );
+
+		return result;
 	}
 }; // class format_t< long >
 #endif // CFGFILE_QT_SUPPORT
@@ -423,32 +632,13 @@ public:
 	static unsigned long from_string( const parser_info_t< string_trait_t > & info,
 		const string_trait_t::string_t & value )
 	{
-		try {
-			std::size_t pos = 0;
-
-			unsigned long result = std::stoul( value, &pos );
+		unsigned long result = 0;
 
-			if( pos != value.length() )
-				throw exception_t< string_trait_t >(
-					string_trait_t::from_ascii( "Invalid value: \"" ) +
-					value + string_trait_t::from_ascii( "\". In file \"" ) +
-					info.file_name() +
-					string_trait_t::from_ascii( "\" on line " ) +
-					string_trait_t::to_string( info.line_number() ) +
-					string_trait_t::from_ascii( "." ) );
+		if( !details::parse_integer( value, result ) )
+			details::report_error( info, error_code_t::invalid_value,
+				string_trait_t::string_t(), value );
 
-			return result;
-		}
-		catch( const std::exception & )
-		{
-			throw exception_t< string_trait_t >(
-				string_trait_t::from_ascii( "Invalid value: \"" ) +
-				value + string_trait_t::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				string_trait_t::from_ascii( "\" on line " ) +
-				string_trait_t::to_string( info.line_number() ) +
-				string_trait_t::from_ascii( "." ) );
-		}
+		return result;
 	}
 }; // class format_t< unsigned long >
 
@@ -466,32 +656,13 @@ public:
 	static unsigned long from_string( const parser_info_t< wstring_trait_t > & info,
 		const wstring_trait_t::string_t & value )
 	{
-		try {
-			std::size_t pos = 0;
-
-			unsigned long result = std::stoul( value, &pos );
+		unsigned long result = 0;
 
-			if( pos != value.length() )
-				throw exception_t< wstring_trait_t >(
-					wstring_trait_t::from_ascii( "Invalid value: \"" ) +
-					value + wstring_trait_t::from_ascii( "\". In file \"" ) +
-					info.file_name() +
-					wstring_trait_t::from_ascii( "\" on line " ) +
-					wstring_trait_t::to_string( info.line_number() ) +
-					wstring_trait_t::from_ascii( "." ) );
+		if( !details::parse_integer( value, result ) )
+			details::report_error( info, error_code_t::invalid_value,
+				wstring_trait_t::string_t(), value );
 
-			return result;
-		}
-		catch( const std::exception & )
-		{
-			throw exception_t< wstring_trait_t >(
-				wstring_trait_t::from_ascii( "Invalid value: \"" ) +
-				value + wstring_trait_t::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				wstring_trait_t::from_ascii( "\" on line " ) +
-				wstring_trait_t::to_string( info.line_number() ) +
-				wstring_trait_t::from_ascii( "." ) );
-		}
+		return result;
 	}
 }; // class format_t< unsigned long >
 
@@ -516,15 +687,10 @@ public:
 		unsigned long result = ((QString)value).toULong( &ok );
 
 		if( !ok )
-			throw exception_t< qstring_trait_t >(
-				qstring_trait_t::from_ascii( "Invalid value: \"" ) +
-				value + qstring_trait_t::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				qstring_trait_t::from_ascii( "\" on line " ) +
-				qstring_trait_t::to_string( info.line_number() ) +
-				qstring_trait_t::from_ascii( "." ) );
-		else
-			return result;
+			details::report_error( info, error_code_t::invalid_value,
+				qstring_trait_t::string_t(), value );
+
+		return result;
 	}
 }; // class format_t< unsigned long >
 #endif // CFGFILE_QT_SUPPORT
@@ -545,32 +711,13 @@ public:
 	static long long from_string( const parser_info_t< string_trait_t > & info,
 		const string_trait_t::string_t & value )
 	{
-		try {
-			std::size_t pos = 0;
+		long long result = 0;
 
-			long long result = std::stoll( value, &pos );
+		if( !details::parse_integer( value, result ) )
+			details::report_error( info, error_code_t::invalid_value,
+				string_trait_t::string_t(), value );
 
-			if( pos != value.length() )
-				throw exception_t< string_trait_t >(
-					string_trait_t::from_ascii( "Invalid value: \"" ) +
-					value + string_trait_t::from_ascii( "\". In file \"" ) +
-					info.file_name() +
-					string_trait_t::from_ascii( "\" on line " ) +
-					string_trait_t::to_string( info.line_number() ) +
-					string_trait_t::from_ascii( "." ) );
-
-			return result;
-		}
-		catch( const std::exception & )
-		{
-			throw exception_t< string_trait_t >(
-				string_trait_t::from_ascii( "Invalid value: \"" ) +
-				value + string_trait_t::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				string_trait_t::from_ascii( "\" on line " ) +
-				string_trait_t::to_string( info.line_number() ) +
-				string_trait_t::from_ascii( "." ) );
-		}
+		return result;
 	}
 }; // class format_t< long long >
 
@@ -588,32 +735,13 @@ public:
 	static long long from_string( const parser_info_t< wstring_trait_t > & info,
 		const wstring_trait_t::string_t & value )
 	{
-		try {
-			std::size_t pos = 0;
-
-			long long result = std::stoll( value, &pos );
+		long long result = 0;
 
-			if( pos != value.length() )
-				throw exception_t< wstring_trait_t >(
-					wstring_trait_t::from_ascii( "Invalid value: \"" ) +
-					value + wstring_trait_t::from_ascii( "\". In file \"" ) +
-					info.file_name() +
-					wstring_trait_t::from_ascii( "\" on line " ) +
-					wstring_trait_t::to_string( info.line_number() ) +
-					wstring_trait_t::from_ascii( "." ) );
+		if( !details::parse_integer( value, result ) )
+			details::report_error( info, error_code_t::invalid_value,
+				wstring_trait_t::string_t(), value );
 
-			return result;
-		}
-		catch( const std::exception & )
-		{
-			throw exception_t< wstring_trait_t >(
-				wstring_trait_t::from_ascii( "Invalid value: \"" ) +
-				value + wstring_trait_t::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				wstring_trait_t::from_ascii( "\" on line " ) +
-				wstring_trait_t::to_string( info.line_number() ) +
-				wstring_trait_t::from_ascii( "." ) );
-		}
+		return result;
 	}
 }; // class format_t< long long >
 
@@ -638,15 +766,10 @@ public:
 		long long result = ((QString)value).toLongLong( &ok );
 
 		if( !ok )
-			throw exception_t< qstring_trait_t >(
-				qstring_trait_t::from_ascii( "Invalid value: \"" ) +
-				value + qstring_trait_t::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				qstring_trait_t::from_ascii( "\" on line " ) +
-				qstring_trait_t::to_string( info.line_number() ) +
-				qstring_trait_t::from_ascii( "." ) );
-		else
-			return result;
+			details::report_error( info, error_code_t::invalid_value,
+				qstring_trait_t::string_t(), value );
+
+		return result;
 	}
 }; // class format_t< long long >
 #endif // CFGFILE_QT_SUPPORT
@@ -667,32 +790,13 @@ public:
 	static unsigned long long from_string( const parser_info_t< string_trait_t > & info,
 		const string_trait_t::string_t & value )
 	{
-		try {
-			std::size_t pos = 0;
+		unsigned long long result = 0;
 
-			unsigned long long result = std::stoull( value, &pos );
+		if( !details::parse_integer( value, result ) )
+			details::report_error( info, error_code_t::invalid_value,
+				string_trait_t::string_t(), value );
 
-			if( pos != value.length() )
-				throw exception_t< string_trait_t >(
-					string_trait_t::from_ascii( "Invalid value: \"" ) +
-					value + string_trait_t::from_ascii( "\". In file \"" ) +
-					info.file_name() +
-					string_trait_t::from_ascii( "\" on line " ) +
-					string_trait_t::to_string( info.line_number() ) +
-					string_trait_t::from_ascii( "." ) );
-
-			return result;
-		}
-		catch( const std::exception & )
-		{
-			throw exception_t< string_trait_t >(
-				string_trait_t::from_ascii( "Invalid value: \"" ) +
-				value + string_trait_t::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				string_trait_t::from_ascii( "\" on line " ) +
-				string_trait_t::to_string( info.line_number() ) +
-				string_trait_t::from_ascii( "." ) );
-		}
+		return result;
 	}
 }; // class format_t< unsigned long long >
 
@@ -710,32 +814,13 @@ public:
 	static unsigned long long from_string( const parser_info_t< wstring_trait_t > & info,
 		const wstring_trait_t::string_t & value )
 	{
-		try {
-			std::size_t pos = 0;
+		unsigned long long result = 0;
 
-			unsigned long long result = std::stoull( value, &pos );
+		if( !details::parse_integer( value, result ) )
+			details::report_error( info, error_code_t::invalid_value,
+				wstring_trait_t::string_t(), value );
 
-			if( pos != value.length() )
-				throw exception_t< wstring_trait_t >(
-					wstring_trait_t::from_ascii( "Invalid value: \"" ) +
-					value + wstring_trait_t::from_ascii( "\". In file \"" ) +
-					info.file_name() +
-					wstring_trait_t::from_ascii( "\" on line " ) +
-					wstring_trait_t::to_string( info.line_number() ) +
-					wstring_trait_t::from_ascii( "." ) );
-
-			return result;
-		}
-		catch( const std::exception & )
-		{
-			throw exception_t< wstring_trait_t >(
-				wstring_trait_t::from_ascii( "Invalid value: \"" ) +
-				value + wstring_trait_t::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				wstring_trait_t::from_ascii( "\" on line " ) +
-				wstring_trait_t::to_string( info.line_number() ) +
-				wstring_trait_t::from_ascii( "." ) );
-		}
+		return result;
 	}
 }; // class format_t< unsigned long long >
 
@@ -760,15 +845,10 @@ public:
 		unsigned long long result = ((QString)value).toULongLong( &ok );
 
 		if( !ok )
-			throw exception_t< qstring_trait_t >(
-				qstring_trait_t::from_ascii( "Invalid value: \"" ) +
-				value + qstring_trait_t::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				qstring_trait_t::from_ascii( "\" on line " ) +
-				qstring_trait_t::to_string( info.line_number() ) +
-				qstring_trait_t::from_ascii( "." ) );
-		else
-			return result;
+			details::report_error( info, error_code_t::invalid_value,
+				qstring_trait_t::string_t(), value );
+
+		return result;
 	}
 }; // class format_t< unsigned long long >
 #endif // CFGFILE_QT_SUPPORT
@@ -782,39 +862,21 @@ public:
 	//! Format value to string.
 	static string_trait_t::string_t to_string( const double & value )
 	{
-		return std::to_string( value );
+		return details::double_to_string( value );
 	}
 
 	//! Format value from string.
 	static double from_string( const parser_info_t< string_trait_t > & info,
 		const string_trait_t::string_t & value )
 	{
-		try {
-			std::size_t pos = 0;
-
-			double result = std::stod( value, &pos );
+		double result = 0.0;
 
-			if( pos != value.length() )
-				throw exception_t< string_trait_t >(
-					string_trait_t::from_ascii( "Invalid value: \"" ) +
-					value + string_trait_t::from_ascii( "\". In file \"" ) +
-					info.file_name() +
-					string_trait_t::from_ascii( "\" on line " ) +
-					string_trait_t::to_string( info.line_number() ) +
-					string_trait_t::from_ascii( "." ) );
+		if( !details::parse_double( value.data(), value.data() + value.size(),
+			result ) )
+				details::report_error( info, error_code_t::invalid_value,
+					string_trait_t::string_t(), value );
 
-			return result;
-		}
-		catch( const std::exception & )
-		{
-			throw exception_t< string_trait_t >(
-				string_trait_t::from_ascii( "Invalid value: \"" ) +
-				value + string_trait_t::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				string_trait_t::from_ascii( "\" on line " ) +
-				string_trait_t::to_string( info.line_number() ) +
-				string_trait_t::from_ascii( "." ) );
-		}
+		return result;
 	}
 }; // class format_t< double >
 
@@ -825,39 +887,23 @@ public:
 	//! Format value to string.
 	static wstring_trait_t::string_t to_string( const double & value )
 	{
-		return std::to_wstring( value );
+		const std::string str = details::double_to_string( value );
+
+		return wstring_trait_t::string_t( str.cbegin(), str.cend() );
 	}
 
 	//! Format value from string.
 	static double from_string( const parser_info_t< wstring_trait_t > & info,
 		const wstring_trait_t::string_t & value )
 	{
-		try {
-			std::size_t pos = 0;
+		double result = 0.0;
 
-			double result = std::stod( value, &pos );
+		if( !details::parse_double( value.data(), value.data() + value.size(),
+			result ) )
+				details::report_error( info, error_code_t::invalid_value,
+					wstring_trait_t::string_t(), value );
 
-			if( pos != value.length() )
-				throw exception_t< wstring_trait_t >(
-					wstring_trait_t::from_ascii( "Invalid value: \"" ) +
-					value + wstring_trait_t::from_ascii( "\". In file \"" ) +
-					info.file_name() +
-					wstring_trait_t::from_ascii( "\" on line " ) +
-					wstring_trait_t::to_string( info.line_number() ) +
-					wstring_trait_t::from_ascii( "." ) );
-
-			return result;
-		}
-		catch( const std::exception & )
-		{
-			throw exception_t< wstring_trait_t >(
-				wstring_trait_t::from_ascii( "Invalid value: \"" ) +
-				value + wstring_trait_t::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				wstring_trait_t::from_ascii( "\" on line " ) +
-				wstring_trait_t::to_string( info.line_number() ) +
-				wstring_trait_t::from_ascii( "." ) );
-		}
+		return result;
 	}
 }; // class format_t< double >
 
@@ -882,15 +928,10 @@ public:
 		double result = ((QString)value).toDouble( &ok );
 
 		if( !ok )
-			throw exception_t< qstring_trait_t >(
-				qstring_trait_t::from_ascii( "Invalid value: \"" ) +
-				value + qstring_trait_t::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				qstring_trait_t::from_ascii( "\" on line " ) +
-				qstring_trait_t::to_string( info.line_number() ) +
-				qstring_trait_t::from_ascii( "." ) );
-		else
-			return result;
+			details::report_error( info, error_code_t::invalid_value,
+				qstring_trait_t::string_t(), value );
+
+		return result;
 	}
 }; // class format_t< double >
 #endif // CFGFILE_QT_SUPPORT
@@ -1097,15 +1138,116 @@ public:
 			value == const_t< Trait >::c_no )
 				return false;
 		else
-			throw exception_t< Trait >(
-				Trait::from_ascii( "Invalid value: \"" ) +
-				value + Trait::from_ascii( "\". In file \"" ) +
-				info.file_name() + Trait::from_ascii( "\" on line " ) +
-				Trait::to_string( info.line_number() ) +
-				Trait::from_ascii( "." ) );
+		{
+			details::report_error( info, error_code_t::invalid_value,
+				typename Trait::string_t(), value );
+
+			return false;
+		}
 	}
 }; // class format_t< bool >
 
+
+#ifndef CFGFILE_DISABLE_STL
+
+namespace details {
+
+//
+// arena_format_t
+//
+
+//! Format for arena_string_trait_t, delegates to string_trait_t.
+template< class T >
+class arena_format_t {
+public:
+	//! Format value to string.
+	static arena_string_trait_t::string_t to_string( const T & value )
+	{
+		const string_trait_t::string_t tmp =
+			format_t< T, string_trait_t >::to_string( value );
+
+		return arena_string_trait_t::string_t( tmp.cbegin(), tmp.cend() );
+	}
+
+	//! Format value from string.
+	static T from_string( const parser_info_t< arena_string_trait_t > & info,
+		const arena_string_trait_t::string_t & value )
+	{
+		error_t< string_trait_t > error;
+
+		// Error is reported again at the info, so the file name isn't copied.
+		source_t< string_trait_t > source;
+
+		source.set_error_sink( &error );
+
+		const T result = format_t< T, string_trait_t >::from_string(
+			parser_info_t< string_trait_t >( source,
+				info.line_number(),
+				info.column_number() ),
+			string_trait_t::string_t( value.cbegin(), value.cend() ) );
+
+		if( error.code() != error_code_t::none )
+			report_error( info, error.code(),
+				arena_string_trait_t::from_ascii( error.tag_name() ),
+				arena_string_trait_t::from_ascii( error.token() ) );
+
+		return result;
+	}
+}; // class arena_format_t
+
+} /* namespace details */
+
+
+template<>
+class format_t< int, arena_string_trait_t >
+	:	public details::arena_format_t< int >
+{
+}; // class format_t< int, arena_string_trait_t >
+
+template<>
+class format_t< unsigned int, arena_string_trait_t >
+	:	public details::arena_format_t< unsigned int >
+{
+}; // class format_t< unsigned int, arena_string_trait_t >
+
+template<>
+class format_t< long, arena_string_trait_t >
+	:	public details::arena_format_t< long >
+{
+}; // class format_t< long, arena_string_trait_t >
+
+template<>
+class format_t< unsigned long, arena_string_trait_t >
+	:	public details::arena_format_t< unsigned long >
+{
+}; // class format_t< unsigned long, arena_string_trait_t >
+
+template<>
+class format_t< long long, arena_string_trait_t >
+	:	public details::arena_format_t< long long >
+{
+}; // class format_t< long long, arena_string_trait_t >
+
+template<>
+class format_t< unsigned long long, arena_string_trait_t >
+	:	public details::arena_format_t< unsigned long long >
+{
+}; // class format_t< unsigned long long, arena_string_trait_t >
+
+template<>
+class format_t< double, arena_string_trait_t >
+	:	public details::arena_format_t< double >
+{
+}; // class format_t< double, arena_string_trait_t >
+
+template<>
+class format_t< std::string, arena_string_trait_t >
+	:	public details::arena_format_t< std::string >
+{
+}; // class format_t< std::string, arena_string_trait_t >
+
+#endif // CFGFILE_DISABLE_STL
+
 } /* namespace cfgfile */
 
 #endif // CFGFILE__FORMAT_HPP__INCLUDED
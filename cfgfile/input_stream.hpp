@@ -10,9 +10,12 @@
 // cfgfile include.
 #include "types.hpp"
 #include "const.hpp"
+#include "string_format.hpp"
 
 // C++ include.
 #include <stack>
+#include <vector>
+#include <algorithm>
 
 
 namespace cfgfile {
@@ -21,35 +24,103 @@ namespace cfgfile {
 static const std::size_t c_buff_size = 512;
 
 
+namespace details {
+
+//
+// find_first_of
+//
+
+/*!
+	\return Position of the first \a a or \a b in [first, last) of
+	the \a data or last.
+*/
+template< typename Char >
+inline std::size_t find_first_of( const Char * data, std::size_t first,
+	std::size_t last, Char a, Char b )
+{
+	const std::size_t pos = find_char( data, first, last, a );
+
+	return find_char( data, first, pos, b );
+}
+
+} /* namespace details */
+
+
 //
 // input_stream_t
 //
 
-//! Input stream for parser.
+/*!
+	Input stream for parser.
+
+	Only the offset is tracked while reading. Line and column numbers
+	are computed on demand from the index of the starts of the lines,
+	that is built from the buffer when positions are asked or before
+	the buffer is refilled.
+*/
 template< typename Trait = string_trait_t >
 class input_stream_t final {
 public:
 	input_stream_t( const typename Trait::string_t & file_name,
 		typename Trait::istream_t & input )
-		:	m_stream( input )
-		,	m_line_number( 1 )
-		,	m_column_number( 1 )
+		:	m_stream( &input )
+		,	m_offset( 0 )
+		,	m_prev_pos( 0 )
+		,	m_prev_count( 0 )
 		,	m_file_name( file_name )
 		,	m_buf_pos( 0 )
 		,	m_stream_pos( 0 )
+		,	m_buf_offset( 0 )
+		,	m_first_line_number( 1 )
+		,	m_indexed_pos( 0 )
+		,	m_is_prev_line_feed( false )
 	{
-		Trait::noskipws( m_stream );
+		reset_index( 0, 1, 1 );
 
-		m_stream_size = Trait::size_of_file( m_stream );
+		init();
+	}
 
-		if( m_stream_size < 0 )
-			m_stream_size = 0;
+	~input_stream_t()
+	{
+	}
 
-		Trait::fill_buf( m_stream, m_buf, c_buff_size, m_stream_pos, m_stream_size );
+	/*!
+		Start reading of another stream.
+
+		Buffers allocated for the previous stream are reused.
+	*/
+	void reset( const typename Trait::string_t & file_name,
+		typename Trait::istream_t & input )
+	{
+		m_stream = &input;
+		m_file_name = file_name;
+		m_offset = 0;
+		m_buf_pos = 0;
+		m_stream_pos = 0;
+
+		clear_stacks();
+		reset_index( 0, 1, 1 );
+
+		init();
 	}
 
-	~input_stream_t()
+	/*!
+		Continue reading from the \a offset, that was reached before
+		on the \a line_number and the \a column_number.
+	*/
+	void seek( typename Trait::pos_t offset,
+		typename Trait::pos_t line_number,
+		typename Trait::pos_t column_number )
 	{
+		m_offset = offset;
+		m_buf_pos = 0;
+		m_stream_pos = offset;
+
+		clear_stacks();
+		reset_index( offset, line_number, column_number );
+
+		Trait::seek( *m_stream, offset );
+		Trait::fill_buf( *m_stream, m_buf, c_buff_size, m_stream_pos, m_stream_size );
 	}
 
 	//! Get a symbol from the stream.
@@ -57,41 +128,44 @@ public:
 	{
 		if( !at_end() )
 		{
-			m_prev_positions.push( { m_column_number, m_line_number } );
-
-			m_column_number += 1;
+			m_prev_offsets[ m_prev_pos ] = m_offset;
+			m_prev_pos = ( m_prev_pos + 1 ) % c_max_put_back;
 
-			typename Trait::char_t ch( 0x00 );
+			if( m_prev_count < c_max_put_back )
+				++m_prev_count;
 
 			if( !m_returned_char.empty() )
 			{
-				ch = m_returned_char.top();
+				const returned_char_t returned = m_returned_char.top();
 
 				m_returned_char.pop();
 
-				if( is_new_line( ch ) )
-				{
-					m_line_number += 1;
-					m_column_number = 1;
-				}
+				m_offset = returned.m_offset;
 
-				return ch;
+				return returned.m_ch;
 			}
 
-			if( m_buf_pos == c_buff_size )
-			{
-				Trait::fill_buf( m_stream, m_buf, c_buff_size, m_stream_pos, m_stream_size );
-				m_buf_pos = 0;
-			}
+			if( m_buf_pos == (size_t) m_buf.size() )
+				refill();
 
-			ch = m_buf[ m_buf_pos ];
+			typename Trait::char_t ch = buf_at( m_buf_pos );
 
 			++m_buf_pos;
+			m_offset += 1;
 
-			if( is_new_line( ch ) )
+			// "\r\n" is read as one new line character.
+			if( ch == const_t< Trait >::c_line_feed && !at_end() )
 			{
-				m_line_number += 1;
-				m_column_number = 1;
+				if( m_buf_pos == (size_t) m_buf.size() )
+					refill();
+
+				if( buf_at( m_buf_pos ) == const_t< Trait >::c_carriage_return )
+				{
+					ch = const_t< Trait >::c_carriage_return;
+
+					++m_buf_pos;
+					m_offset += 1;
+				}
 			}
 
 			return ch;
@@ -100,38 +174,146 @@ public:
 			return typename Trait::char_t( 0x00 );
 	}
 
-	//! Put symbol back in the stream.
+	/*!
+		Put symbol back in the stream. Up to c_max_put_back
+		symbols can be put back in a row.
+	*/
 	void put_back( typename Trait::char_t ch )
 	{
-		if( !m_prev_positions.empty() )
+		if( m_prev_count > 0 )
 		{
-			const auto prev = m_prev_positions.top();
-			m_prev_positions.pop();
+			--m_prev_count;
+			m_prev_pos = ( m_prev_pos + c_max_put_back - 1 ) % c_max_put_back;
+
+			m_returned_char.push( { ch, m_offset } );
+
+			m_offset = m_prev_offsets[ m_prev_pos ];
+		}
+	}
+
+	/*!
+		Skip symbols up to the end of the line, new line is skipped too.
+		Buffer is searched for the new line without reading each symbol.
+	*/
+	void skip_line()
+	{
+		while( !at_end() )
+		{
+			if( m_returned_char.empty() )
+			{
+				if( m_buf_pos == (size_t) m_buf.size() )
+				{
+					refill();
+
+					continue;
+				}
+
+				skip_in_buf( details::find_first_of( buf_data(), m_buf_pos,
+					(size_t) m_buf.size(), const_t< Trait >::c_carriage_return,
+					const_t< Trait >::c_line_feed ) );
+
+				if( m_buf_pos == (size_t) m_buf.size() )
+					continue;
+			}
+
+			const typename Trait::char_t ch = get();
+
+			if( ch == const_t< Trait >::c_carriage_return ||
+				ch == const_t< Trait >::c_line_feed )
+					break;
+		}
+
+		// Skipped symbols can't be put back.
+		m_prev_count = 0;
+	}
+
+	/*!
+		Skip symbols up to and including the \a first followed by
+		the \a second. Buffer is searched for the \a first without
+		reading each symbol.
+	*/
+	void skip_past( typename Trait::char_t first,
+		typename Trait::char_t second )
+	{
+		bool is_first = false;
+
+		while( !at_end() )
+		{
+			if( !m_returned_char.empty() )
+			{
+				const typename Trait::char_t ch = get();
+
+				if( is_first && ch == second )
+					break;
+
+				is_first = ( ch == first );
+
+				continue;
+			}
+
+			if( m_buf_pos == (size_t) m_buf.size() )
+			{
+				refill();
+
+				continue;
+			}
 
-			m_column_number = prev.m_column_number;
-			m_line_number = prev.m_line_number;
+			if( is_first && buf_at( m_buf_pos ) == second )
+			{
+				skip_in_buf( m_buf_pos + 1 );
+
+				break;
+			}
+
+			skip_in_buf( details::find_char( buf_data(), m_buf_pos,
+				(size_t) m_buf.size(), first ) );
+
+			is_first = ( m_buf_pos < (size_t) m_buf.size() );
 
-			m_returned_char.push( ch );
+			if( is_first )
+				skip_in_buf( m_buf_pos + 1 );
 		}
+
+		// Skipped symbols can't be put back.
+		m_prev_count = 0;
 	}
 
 	//! \return Line number.
 	typename Trait::pos_t line_number() const
 	{
-		return m_line_number;
+		return line_number( m_offset );
 	}
 
 	//! \return Column number.
 	typename Trait::pos_t column_number() const
 	{
-		return m_column_number;
+		return column_number( m_offset );
+	}
+
+	//! \return Line number of the \a offset that was read before.
+	typename Trait::pos_t line_number( typename Trait::pos_t offset ) const
+	{
+		return m_first_line_number +
+			static_cast< typename Trait::pos_t > ( line_index( offset ) );
+	}
+
+	//! \return Column number of the \a offset that was read before.
+	typename Trait::pos_t column_number( typename Trait::pos_t offset ) const
+	{
+		return offset - m_line_starts[ line_index( offset ) ] + 1;
+	}
+
+	//! \return Amount of read characters from the start of the stream.
+	typename Trait::pos_t offset() const
+	{
+		return m_offset;
 	}
 
 	//! \return Is stream at end?
 	bool at_end() const
 	{
 		if( m_returned_char.empty() )
-			return ( Trait::is_at_end( m_stream ) && m_buf_pos == (size_t) m_buf.size() );
+			return ( Trait::is_at_end( *m_stream ) && m_buf_pos == (size_t) m_buf.size() );
 		else
 			return false;
 	}
@@ -143,81 +325,174 @@ public:
 	}
 
 private:
-	bool is_new_line( typename Trait::char_t & ch )
+	//! Forget returned characters and previous positions.
+	void clear_stacks()
 	{
-		if( ch == const_t< Trait >::c_carriage_return )
-			return true;
-		else if( ch == const_t< Trait >::c_line_feed )
-		{
-			typename Trait::char_t next_char( 0x00 );
+		m_prev_pos = 0;
+		m_prev_count = 0;
+
+		while( !m_returned_char.empty() )
+			m_returned_char.pop();
+	}
 
-			next_char = simple_get();
+	//! Prepare the stream for reading.
+	void init()
+	{
+		Trait::noskipws( *m_stream );
 
-			if( next_char == const_t< Trait >::c_carriage_return )
-			{
-				ch = next_char;
+		m_stream_size = Trait::size_of_file( *m_stream );
 
-				return true;
-			}
-			else
-			{
-				m_returned_char.push( next_char );
+		if( m_stream_size < 0 )
+			m_stream_size = 0;
 
-				return true;
-			}
-		}
-		else
-			return false;
+		Trait::fill_buf( *m_stream, m_buf, c_buff_size, m_stream_pos, m_stream_size );
 	}
 
-	typename Trait::char_t simple_get()
+	/*!
+		\return Character of the buffer. Buffer is accessed as constant,
+		so QString isn't checked for detaching on each character.
+	*/
+	typename Trait::char_t buf_at( std::size_t pos ) const
 	{
-		if( !m_returned_char.empty() )
-		{
-			auto ch = m_returned_char.top();
+		return m_buf[ pos ];
+	}
 
-			m_returned_char.pop();
+	//! \return Data of the buffer, QString isn't detached.
+	const typename Trait::char_t * buf_data() const
+	{
+		return m_buf.data();
+	}
 
-			return ch;
-		}
-		else
+	//! Skip symbols of the buffer up to the \a pos.
+	void skip_in_buf( std::size_t pos )
+	{
+		m_offset += static_cast< typename Trait::pos_t > ( pos - m_buf_pos );
+		m_buf_pos = pos;
+	}
+
+	//! Read next part of the stream into the buffer.
+	void refill()
+	{
+		index_new_lines( (size_t) m_buf.size() );
+
+		m_buf_offset += static_cast< typename Trait::pos_t > ( m_buf.size() );
+		m_indexed_pos = 0;
+
+		Trait::fill_buf( *m_stream, m_buf, c_buff_size, m_stream_pos, m_stream_size );
+		m_buf_pos = 0;
+	}
+
+	/*!
+		Start the index of the lines from the \a offset on the
+		\a line_number and the \a column_number.
+	*/
+	void reset_index( typename Trait::pos_t offset,
+		typename Trait::pos_t line_number,
+		typename Trait::pos_t column_number )
+	{
+		m_buf_offset = offset;
+		m_first_line_number = line_number;
+		m_indexed_pos = 0;
+		m_is_prev_line_feed = false;
+		m_line_starts.assign( 1, offset - column_number + 1 );
+	}
+
+	/*!
+		Add starts of the lines in the buffer up to the \a last.
+
+		New lines are searched with find_char(), that is memchr() or
+		wmemchr() for std::string and std::wstring.
+	*/
+	void index_new_lines( std::size_t last ) const
+	{
+		if( last <= m_indexed_pos )
+			return;
+
+		const typename Trait::char_t * data = buf_data();
+		const std::size_t first = m_indexed_pos;
+
+		std::size_t lf = details::find_char( data, first, last,
+			const_t< Trait >::c_line_feed );
+		std::size_t cr = details::find_char( data, first, last,
+			const_t< Trait >::c_carriage_return );
+
+		while( lf < last || cr < last )
 		{
-			typename Trait::char_t ch( 0x00 );
+			const std::size_t pos = std::min( lf, cr );
+			const typename Trait::pos_t start =
+				m_buf_offset + static_cast< typename Trait::pos_t > ( pos ) + 1;
 
-			if( m_buf_pos == c_buff_size )
+			if( pos == cr )
 			{
-				Trait::fill_buf( m_stream, m_buf, c_buff_size, m_stream_pos, m_stream_size );
-				m_buf_pos = 0;
+				// "\r\n" is one new line.
+				const bool is_after_line_feed = ( pos > first ?
+					data[ pos - 1 ] == const_t< Trait >::c_line_feed :
+					m_is_prev_line_feed );
+
+				if( is_after_line_feed )
+					m_line_starts.back() = start;
+				else
+					m_line_starts.push_back( start );
+
+				cr = details::find_char( data, pos + 1, last,
+					const_t< Trait >::c_carriage_return );
 			}
+			else
+			{
+				m_line_starts.push_back( start );
 
-			ch = m_buf[ m_buf_pos ];
+				lf = details::find_char( data, pos + 1, last,
+					const_t< Trait >::c_line_feed );
+			}
+		}
 
-			++m_buf_pos;
+		m_is_prev_line_feed = ( data[ last - 1 ] == const_t< Trait >::c_line_feed );
+		m_indexed_pos = last;
+	}
 
-			return ch;
-		}
+	//! \return Index of the line with the \a offset.
+	std::size_t line_index( typename Trait::pos_t offset ) const
+	{
+		index_new_lines( m_buf_pos );
+
+		if( offset >= m_line_starts.back() )
+			return m_line_starts.size() - 1;
+
+		const auto it = std::upper_bound( m_line_starts.cbegin(),
+			m_line_starts.cend(), offset );
+
+		return ( it == m_line_starts.cbegin() ? 0 :
+			static_cast< std::size_t > ( it - m_line_starts.cbegin() ) - 1 );
 	}
 
 private:
 	DISABLE_COPY( input_stream_t )
 
-	struct position_t {
-		typename Trait::pos_t m_column_number;
-		typename Trait::pos_t m_line_number;
+	//! Max amount of symbols put back in a row.
+	static const std::size_t c_max_put_back = 8;
+
+	//! Symbol put back.
+	struct returned_char_t {
+		//! Symbol.
+		typename Trait::char_t m_ch;
+		//! Offset after the symbol.
+		typename Trait::pos_t m_offset;
 	};
 
 	//! Underline input stream.
-	typename Trait::istream_t & m_stream;
-	//! Line number.
-	typename Trait::pos_t m_line_number;
-	//! Column number.
-	typename Trait::pos_t m_column_number;
-	//! Previous positions.
-	std::stack< position_t > m_prev_positions;
+	typename Trait::istream_t * m_stream;
+	//! Offset from the start of the stream.
+	typename Trait::pos_t m_offset;
+	//! Offsets before the last read symbols.
+	typename Trait::pos_t m_prev_offsets[ c_max_put_back ];
+	//! Position of the next offset in m_prev_offsets.
+	std::size_t m_prev_pos;
+	//! Amount of the offsets in m_prev_offsets.
+	std::size_t m_prev_count;
 	//! File name.
 	typename Trait::string_t m_file_name;
 	//! Returned char.
-	std::stack< typename Trait::char_t > m_returned_char;
+	std::stack< returned_char_t > m_returned_char;
 	//! Buffer.
 	typename Trait::buf_t m_buf;
 	//! Buffer position.
@@ -226,6 +501,16 @@ private:
 	typename Trait::pos_t m_stream_size;
 	//! Current position in the stream.
 	typename Trait::pos_t m_stream_pos;
+	//! Offset of the first symbol of the buffer.
+	typename Trait::pos_t m_buf_offset;
+	//! Line number of the first start of the line in the index.
+	typename Trait::pos_t m_first_line_number;
+	//! Offsets of the starts of the lines.
+	mutable std::vector< typename Trait::pos_t > m_line_starts;
+	//! Position in the buffer up to which the lines are indexed.
+	mutable std::size_t m_indexed_pos;
+	//! Was the last indexed symbol "\r"?
+	mutable bool m_is_prev_line_feed;
 }; // class input_stream_t
 
 } /* namespace cfgfile */
@@ -11,6 +11,16 @@
 #include "types.hpp"
 #include "input_stream.hpp"
 #include "exceptions.hpp"
+#include "parser_info.hpp"
+
+#ifndef CFGFILE_DISABLE_STL
+// C++ include.
+#include <cstdint>
+#include <cstring>
+#endif
+
+// C++ include.
+#include <utility>
 
 
 namespace cfgfile {
@@ -63,6 +73,12 @@ public:
 		return m_value;
 	}
 
+	//! \return Lexeme value moved out of the lexeme.
+	typename Trait::string_t take_value()
+	{
+		return std::move( m_value );
+	}
+
     //! \return Is lexeme a null lexeme.
     bool is_null() const
 	{
@@ -85,17 +101,21 @@ private:
 template< typename Trait = string_trait_t >
 class lexical_analyzer_t final {
 public:
+	//! Type of the input stream.
+	using stream_t = input_stream_t< Trait >;
+
 	explicit lexical_analyzer_t( input_stream_t< Trait > & stream )
 		:	m_stream( stream )
-		,	m_line_number( m_stream.line_number() )
-		,	m_column_number( m_stream.column_number() )
+		,	m_offset( m_stream.offset() )
+		,	m_error( nullptr )
 	{
 	}
 
 	/*!
 		\return Next lexeme.
 
-		\throw Exception on lexical error.
+		\throw Exception on lexical error if there is no error sink.
+		With the sink null lexeme is returned and has_error() is true.
 	*/
 	lexeme_t< Trait > next_lexeme()
 	{
@@ -107,8 +127,13 @@ public:
 
 		skip_spaces();
 
-		m_line_number = m_stream.line_number();
-		m_column_number = m_stream.column_number();
+		m_offset = m_stream.offset();
+
+		if( m_limits.m_max_size &&
+			static_cast< std::size_t > ( m_offset ) > m_limits.m_max_size )
+				return fail( error_code_t::limit_exceeded,
+					line_number(), column_number(),
+					Trait::from_ascii( "size" ) );
 
 		if( m_stream.at_end() )
 			return lexeme_t< Trait >( lexeme_type_t::null,
@@ -116,97 +141,98 @@ public:
 
 		while( true )
 		{
+			// Size is checked for each character, a lexeme may be long.
+			if( m_limits.m_max_size &&
+				static_cast< std::size_t > ( m_stream.offset() ) >=
+					m_limits.m_max_size )
+						return fail( error_code_t::limit_exceeded,
+							line_number(), column_number(),
+							Trait::from_ascii( "size" ) );
+
+			if( m_limits.m_max_lexeme_length &&
+				static_cast< std::size_t > ( result.length() ) >
+					m_limits.m_max_lexeme_length )
+						return fail( error_code_t::limit_exceeded,
+							line_number(), column_number(),
+							Trait::from_ascii( "lexeme length" ) );
+
 			typename Trait::char_t ch = m_stream.get();
 
-			if( ch == const_t< Trait >::c_quotes )
+			switch( const_t< Trait >::char_class( ch ) )
 			{
-				if( quoted_lexeme )
-					break;
-				else if( first_symbol )
-					quoted_lexeme = true;
-				else
+				case details::char_class_t::quotes :
 				{
-					m_stream.put_back( ch );
+					if( quoted_lexeme )
+						return lexeme_t< Trait >( lexeme_type_t::string, result );
+					else if( first_symbol )
+						quoted_lexeme = true;
+					else
+					{
+						m_stream.put_back( ch );
 
-					break;
+						return lexeme_t< Trait >( lexeme_type_t::string, result );
+					}
 				}
-			}
-			else if( ch == const_t< Trait >::c_back_slash )
-			{
-				typename Trait::char_t new_char( 0x00 );
+					break;
 
-				if( !quoted_lexeme )
-					result.push_back( ch );
-				else if( process_back_slash( new_char ) )
-					result.push_back( new_char );
-				else
-					throw exception_t< Trait >(
-						Trait::from_ascii( "Unrecognized back-slash "
-							"sequence: \"\\" ) +
-						typename Trait::string_t( 1, new_char ) +
-						Trait::from_ascii( "\". In file \"" ) +
-						m_stream.file_name() +
-						Trait::from_ascii( "\" on line " ) +
-						Trait::to_string( line_number() ) +
-						Trait::from_ascii( "." ) );
-			}
-			else if( ch == const_t< Trait >::c_begin_tag )
-			{
-				if( result.empty() )
-					return lexeme_t< Trait >( lexeme_type_t::start,
-						typename Trait::string_t( 1, ch ) );
-				else if( quoted_lexeme )
-					result.push_back( ch );
-				else
+				case details::char_class_t::back_slash :
 				{
-					m_stream.put_back( ch );
+					typename Trait::char_t new_char( 0x00 );
 
-					break;
+					if( !quoted_lexeme )
+						result.push_back( ch );
+					else if( process_back_slash( new_char ) )
+						result.push_back( new_char );
+					else
+						return fail( error_code_t::unrecognized_back_slash_sequence,
+							line_number(), column_number(),
+							typename Trait::string_t( 1, new_char ) );
 				}
-			}
-			else if( ch == const_t< Trait >::c_end_tag )
-			{
-				if( result.empty() )
-					return lexeme_t< Trait >( lexeme_type_t::finish,
-						typename Trait::string_t( 1, ch ) );
-				else if( quoted_lexeme )
-					result.push_back( ch );
-				else
+					break;
+
+				case details::char_class_t::begin_tag :
+				case details::char_class_t::end_tag :
 				{
-					m_stream.put_back( ch );
+					if( result.empty() )
+						return lexeme_t< Trait >(
+							ch == const_t< Trait >::c_begin_tag ?
+								lexeme_type_t::start : lexeme_type_t::finish,
+							typename Trait::string_t( 1, ch ) );
+					else if( quoted_lexeme )
+						result.push_back( ch );
+					else
+					{
+						m_stream.put_back( ch );
 
+						return lexeme_t< Trait >( lexeme_type_t::string, result );
+					}
+				}
 					break;
+
+				case details::char_class_t::space :
+				{
+					if( quoted_lexeme )
+						result.push_back( ch );
+					else
+						return lexeme_t< Trait >( lexeme_type_t::string, result );
 				}
-			}
-			else if( ch == const_t< Trait >::c_space ||
-				ch == const_t< Trait >::c_tab )
-			{
-				if( quoted_lexeme )
-					result.push_back( ch );
-				else
 					break;
-			}
-			else if( ch == const_t< Trait >::c_carriage_return ||
-				ch == const_t< Trait >::c_line_feed )
-			{
-				if( quoted_lexeme )
-					throw exception_t< Trait >(
-						Trait::from_ascii( "Unfinished quoted lexeme. " ) +
-						Trait::from_ascii( "New line detected. In file \"" ) +
-						m_stream.file_name() +
-						Trait::from_ascii( "\" on line " ) +
-						Trait::to_string( line_number() ) +
-						Trait::from_ascii( "." ) );
-				else
+
+				case details::char_class_t::new_line :
+				{
+					if( quoted_lexeme )
+						return fail( error_code_t::new_line_in_quoted_lexeme,
+							line_number(), column_number() );
+					else
+						return lexeme_t< Trait >( lexeme_type_t::string, result );
+				}
 					break;
-			}
-			else if( ch == const_t< Trait >::c_vertical_bar )
-			{
-				if( quoted_lexeme )
-					result.push_back( ch );
-				else
+
+				case details::char_class_t::vertical_bar :
 				{
-					if( !m_stream.at_end() )
+					if( quoted_lexeme )
+						result.push_back( ch );
+					else if( !m_stream.at_end() )
 					{
 						typename Trait::char_t next_char = m_stream.get();
 
@@ -219,7 +245,8 @@ public:
 							if( first_symbol )
 								skip_spaces();
 							else
-								break;
+								return lexeme_t< Trait >( lexeme_type_t::string,
+									result );
 						}
 						else if( next_char == const_t< Trait >::c_sharp )
 						{
@@ -230,7 +257,8 @@ public:
 							if( first_symbol )
 								skip_spaces();
 							else
-								break;
+								return lexeme_t< Trait >( lexeme_type_t::string,
+									result );
 						}
 						else
 						{
@@ -242,25 +270,22 @@ public:
 					else
 						result.push_back( ch );
 				}
+					break;
+
+				default :
+					result.push_back( ch );
 			}
-			else
-				result.push_back( ch );
 
 			if( m_stream.at_end() )
 			{
 				if( quoted_lexeme )
-					throw exception_t< Trait >(
-						Trait::from_ascii( "Unfinished quoted lexeme. " ) +
-						Trait::from_ascii( "End of file riched. In file \"" ) +
-						m_stream.file_name() +
-						Trait::from_ascii( "\" on line " ) +
-						Trait::to_string( line_number() ) +
-						Trait::from_ascii( "." ) );
+					return fail( error_code_t::end_of_file_in_quoted_lexeme,
+						line_number(), column_number() );
 				else if( result.empty() )
 					return lexeme_t< Trait >( lexeme_type_t::null,
 						typename Trait::string_t() );
 				else
-					break;
+					return lexeme_t< Trait >( lexeme_type_t::string, result );
 			}
 
 			if( !skip_comment )
@@ -268,8 +293,6 @@ public:
 			else
 				skip_comment = false;
 		}
-
-		return lexeme_t< Trait >( lexeme_type_t::string, result );
 	}
 
     //! \return Input stream.
@@ -278,28 +301,100 @@ public:
 		return m_stream;
 	}
 
-	//! \return Line number.
+	//! \return File name.
+	const typename Trait::string_t & file_name() const
+	{
+		return m_stream.file_name();
+	}
+
+	//! Start from the current position of the input stream.
+	void reset()
+	{
+		m_offset = m_stream.offset();
+	}
+
+	/*!
+		Continue from the \a offset of the input stream, that was
+		reached before on the \a line_number and the \a column_number.
+	*/
+	void seek( typename Trait::pos_t offset,
+		typename Trait::pos_t line_number,
+		typename Trait::pos_t column_number )
+	{
+		m_stream.seek( offset, line_number, column_number );
+
+		reset();
+	}
+
+	/*!
+		Store errors in the \a error instead of throwing exceptions.
+		nullptr turns exceptions back on.
+	*/
+	void set_error_sink( details::error_t< Trait > * error )
+	{
+		m_error = error;
+	}
+
+	//! Set limits of the size and the length of the lexemes.
+	void set_limits( const parse_limits_t & limits )
+	{
+		m_limits = limits;
+	}
+
+	//! \return Is error stored in the error sink?
+	bool has_error() const
+	{
+		return ( m_error && m_error->code() != error_code_t::none );
+	}
+
+	//! \return Line number of the current lexeme.
 	typename Trait::pos_t line_number() const
 	{
-		return m_line_number;
+		return m_stream.line_number( m_offset );
 	}
 
-	//! \return Column number.
+	//! \return Column number of the current lexeme.
 	typename Trait::pos_t column_number() const
 	{
-		return m_column_number;
+		return m_stream.column_number( m_offset );
+	}
+
+	//! \return Offset of the current lexeme in the input stream.
+	typename Trait::pos_t offset() const
+	{
+		return m_offset;
 	}
 
 private:
+	/*!
+		Report error. Throws without error sink, else stores
+		the first error in the sink.
+
+		\return Null lexeme.
+	*/
+	lexeme_t< Trait > fail( error_code_t code,
+		typename Trait::pos_t line_number,
+		typename Trait::pos_t column_number,
+		const typename Trait::string_t & token = typename Trait::string_t() )
+	{
+		if( !m_error )
+			details::throw_error< Trait >( code, m_stream.file_name(),
+				line_number, column_number, typename Trait::string_t(), token );
+
+		if( !has_error() )
+			*m_error = details::error_t< Trait >( code, m_stream.file_name(),
+				line_number, column_number, typename Trait::string_t(), token );
+
+		return lexeme_t< Trait >();
+	}
+
 	//! \return Is character a space character?
-	bool is_space_char( typename Trait::char_t ch )
+	static bool is_space_char( typename Trait::char_t ch )
 	{
-		if( ch == const_t< Trait >::c_space || ch == const_t< Trait >::c_tab ||
-			ch == const_t< Trait >::c_carriage_return ||
-			ch == const_t< Trait >::c_line_feed )
-				return true;
-		else
-			return false;
+		const details::char_class_t c = const_t< Trait >::char_class( ch );
+
+		return ( c == details::char_class_t::space ||
+			c == details::char_class_t::new_line );
 	}
 
 	//! Skip spaces in the stream.
@@ -325,12 +420,12 @@ private:
 	bool process_back_slash( typename Trait::char_t & ch )
 	{
 		if( m_stream.at_end() )
-			throw exception_t< Trait >(
-				Trait::from_ascii( "Unexpected end of file. "
-					"Unfinished back slash sequence. In file \"" ) +
-				m_stream.file_name() + Trait::from_ascii( "\" on line " ) +
-				Trait::to_string( m_stream.line_number() ) +
-				Trait::from_ascii( "." ) );
+		{
+			fail( error_code_t::end_of_file_in_back_slash_sequence,
+				m_stream.line_number(), m_stream.column_number() );
+
+			return false;
+		}
 
 		ch = m_stream.get();
 
@@ -353,56 +448,279 @@ private:
 	//! Skip one-line comment.
 	void skip_one_line_comment()
 	{
-		if( !m_stream.at_end() )
-		{
-			typename Trait::char_t ch = m_stream.get();
-
-			while( ch != const_t< Trait >::c_carriage_return &&
-				ch != const_t< Trait >::c_line_feed &&
-				!m_stream.at_end() )
-					ch = m_stream.get();
-		}
+		m_stream.skip_line();
 	}
 
 	//! Skip multi-line comment.
 	void skip_multi_line_comment()
 	{
-		if( !m_stream.at_end() )
+		m_stream.skip_past( const_t< Trait >::c_sharp,
+			const_t< Trait >::c_vertical_bar );
+	}
+
+private:
+	DISABLE_COPY( lexical_analyzer_t )
+
+	//! Input stream.
+	input_stream_t< Trait > & m_stream;
+	//! Offset of the current lexeme, line and column are computed from it.
+	typename Trait::pos_t m_offset;
+	//! Error sink.
+	details::error_t< Trait > * m_error;
+	//! Limits.
+	parse_limits_t m_limits;
+}; // class lexical_analyzer_t
+
+
+#ifndef CFGFILE_DISABLE_STL
+
+namespace details {
+
+//! Replacement character for malformed UTF-8.
+static const wchar_t c_replacement_char = 0xFFFD;
+
+/*!
+	Decode UTF-8 to std::wstring.
+
+	ASCII is widened eight bytes at a time. Malformed sequences
+	are replaced with U+FFFD. With 16-bit wchar_t code points
+	above U+FFFF become surrogate pairs.
+*/
+inline std::wstring utf8_to_wstring( const std::string & str )
+{
+	// Never more code units than bytes.
+	std::wstring res( str.size(), wchar_t( 0 ) );
+
+	const unsigned char * p =
+		reinterpret_cast< const unsigned char* > ( str.data() );
+	const unsigned char * const end = p + str.size();
+	std::size_t n = 0;
+
+	while( p != end )
+	{
+		while( end - p >= 8 )
 		{
-			typename Trait::char_t ch = m_stream.get();
+			std::uint64_t word = 0;
+			std::memcpy( &word, p, sizeof( word ) );
 
-			if( m_stream.at_end() )
-				return;
+			if( word & 0x8080808080808080ull )
+				break;
 
-			typename Trait::char_t next_char = m_stream.get();
+			for( std::size_t i = 0; i < 8; ++i )
+				res[ n + i ] = static_cast< wchar_t > ( p[ i ] );
 
-			if( ch == const_t< Trait >::c_sharp &&
-				next_char == const_t< Trait >::c_vertical_bar )
-					return;
+			p += 8;
+			n += 8;
+		}
 
-			while( !m_stream.at_end() )
-			{
-				ch = next_char;
+		if( p == end )
+			break;
 
-				next_char = m_stream.get();
+		const std::uint32_t lead = *p;
 
-				if( ch == const_t< Trait >::c_sharp &&
-					next_char == const_t< Trait >::c_vertical_bar )
-						break;
-			}
+		if( lead < 0x80 )
+		{
+			res[ n++ ] = static_cast< wchar_t > ( lead );
+			++p;
+
+			continue;
 		}
+
+		std::uint32_t cp = 0;
+		std::uint32_t min = 0;
+		std::ptrdiff_t length = 0;
+
+		if( ( lead & 0xE0 ) == 0xC0 )
+		{
+			cp = lead & 0x1F;
+			min = 0x80;
+			length = 2;
+		}
+		else if( ( lead & 0xF0 ) == 0xE0 )
+		{
+			cp = lead & 0x0F;
+			min = 0x800;
+			length = 3;
+		}
+		else if( ( lead & 0xF8 ) == 0xF0 )
+		{
+			cp = lead & 0x07;
+			min = 0x10000;
+			length = 4;
+		}
+
+		bool valid = ( length != 0 && end - p >= length );
+
+		for( std::ptrdiff_t i = 1; valid && i < length; ++i )
+		{
+			if( ( p[ i ] & 0xC0 ) != 0x80 )
+				valid = false;
+			else
+				cp = ( cp << 6 ) | ( p[ i ] & 0x3F );
+		}
+
+		if( !valid || cp < min || cp > 0x10FFFF ||
+			( cp >= 0xD800 && cp <= 0xDFFF ) )
+		{
+			res[ n++ ] = c_replacement_char;
+			++p;
+
+			continue;
+		}
+
+		p += length;
+
+		if( sizeof( wchar_t ) == 2 && cp >= 0x10000 )
+		{
+			cp -= 0x10000;
+			res[ n++ ] = static_cast< wchar_t > ( 0xD800 + ( cp >> 10 ) );
+			res[ n++ ] = static_cast< wchar_t > ( 0xDC00 + ( cp & 0x3FF ) );
+		}
+		else
+			res[ n++ ] = static_cast< wchar_t > ( cp );
+	}
+
+	res.resize( n );
+
+	return res;
+}
+
+} /* namespace details */
+
+
+//
+// utf8_lexical_analyzer_t
+//
+
+/*!
+	Lexical analyzer of UTF-8 input for std::wstring tags.
+
+	Lexing is done on bytes with lexical_analyzer_t< string_trait_t >,
+	only values of the lexemes are decoded to std::wstring. Column
+	numbers are counted in bytes.
+*/
+class utf8_lexical_analyzer_t final {
+public:
+	//! Type of the input stream.
+	using stream_t = input_stream_t< string_trait_t >;
+
+	explicit utf8_lexical_analyzer_t( stream_t & stream )
+		:	m_lex( stream )
+		,	m_file_name( details::utf8_to_wstring( stream.file_name() ) )
+		,	m_error( nullptr )
+	{
+	}
+
+	/*!
+		\return Next lexeme.
+
+		\throw Exception on lexical error if there is no error sink.
+	*/
+	lexeme_t< wstring_trait_t > next_lexeme()
+	{
+		try {
+			const lexeme_t< string_trait_t > lexeme = m_lex.next_lexeme();
+
+			if( m_lex.has_error() && m_error->code() == error_code_t::none )
+				*m_error = to_wide( m_bytes_error );
+
+			return lexeme_t< wstring_trait_t >( lexeme.type(),
+				details::utf8_to_wstring( lexeme.value() ) );
+		}
+		catch( const exception_t< string_trait_t > & x )
+		{
+			throw to_wide( x );
+		}
+	}
+
+	//! Start from the current position of the input stream.
+	void reset()
+	{
+		m_lex.reset();
+	}
+
+	//! Continue from the \a offset of the input stream.
+	void seek( wstring_trait_t::pos_t offset,
+		wstring_trait_t::pos_t line_number,
+		wstring_trait_t::pos_t column_number )
+	{
+		m_lex.seek( offset, line_number, column_number );
+	}
+
+	//! Store errors in the \a error instead of throwing exceptions.
+	void set_error_sink( details::error_t< wstring_trait_t > * error )
+	{
+		m_error = error;
+		m_bytes_error = details::error_t< string_trait_t >();
+		m_lex.set_error_sink( error ? &m_bytes_error : nullptr );
+	}
+
+	//! Set limits of the size and the length of the lexemes in bytes.
+	void set_limits( const parse_limits_t & limits )
+	{
+		m_lex.set_limits( limits );
+	}
+
+	//! \return Is error stored in the error sink?
+	bool has_error() const
+	{
+		return m_lex.has_error();
+	}
+
+	//! \return Line number.
+	wstring_trait_t::pos_t line_number() const
+	{
+		return m_lex.line_number();
+	}
+
+	//! \return Column number.
+	wstring_trait_t::pos_t column_number() const
+	{
+		return m_lex.column_number();
+	}
+
+	//! \return Offset of the current lexeme in bytes.
+	wstring_trait_t::pos_t offset() const
+	{
+		return m_lex.offset();
+	}
+
+	//! \return File name.
+	const wstring_trait_t::string_t & file_name() const
+	{
+		return m_file_name;
 	}
 
 private:
-	DISABLE_COPY( lexical_analyzer_t )
+	//! \return Error with decoded strings.
+	static exception_t< wstring_trait_t > to_wide(
+		const details::error_t< string_trait_t > & x )
+	{
+		if( x.code() == error_code_t::custom )
+			return exception_t< wstring_trait_t >(
+				details::utf8_to_wstring( x.desc() ) );
+		else
+			return exception_t< wstring_trait_t >( x.code(),
+				details::utf8_to_wstring( x.file_name() ),
+				x.line_number(), x.column_number(),
+				details::utf8_to_wstring( x.tag_name() ),
+				details::utf8_to_wstring( x.token() ) );
+	}
 
-	//! Input stream.
-	input_stream_t< Trait > & m_stream;
-	//! Line number.
-	typename Trait::pos_t m_line_number;
-	//! Column number.
-	typename Trait::pos_t m_column_number;
-}; // class lexical_analyzer_t
+private:
+	DISABLE_COPY( utf8_lexical_analyzer_t )
+
+	//! Lexical analyzer of bytes.
+	lexical_analyzer_t< string_trait_t > m_lex;
+	//! File name.
+	wstring_trait_t::string_t m_file_name;
+	//! Error sink.
+	details::error_t< wstring_trait_t > * m_error;
+	//! Error of the lexical analyzer of bytes.
+	details::error_t< string_trait_t > m_bytes_error;
+}; // class utf8_lexical_analyzer_t
+
+#endif // CFGFILE_DISABLE_STL
 
 } /* namespace cfgfile */
 
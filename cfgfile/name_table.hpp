@@ -0,0 +1,181 @@
+/*
+	SPDX-FileCopyrightText: 2017-2024 Igor Mironchik <igor.mironchik@gmail.com>
+	SPDX-License-Identifier: MIT
+*/
+
+#ifndef CFGFILE__NAME_TABLE_HPP__INCLUDED
+#define CFGFILE__NAME_TABLE_HPP__INCLUDED
+
+// cfgfile include.
+#include "types.hpp"
+
+// C++ include.
+#include <unordered_set>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace cfgfile {
+
+namespace details {
+
+//
+// char_code
+//
+
+inline std::size_t char_code( char ch )
+{
+	return static_cast< unsigned char > ( ch );
+}
+
+inline std::size_t char_code( wchar_t ch )
+{
+	return static_cast< std::size_t > ( ch );
+}
+
+#ifdef CFGFILE_QT_SUPPORT
+inline std::size_t char_code( QChar ch )
+{
+	return ch.unicode();
+}
+#endif // CFGFILE_QT_SUPPORT
+
+
+//
+// name_hash_t
+//
+
+//! Hash of the tag's name, works with any Trait::string_t.
+template< typename Trait >
+struct name_hash_t {
+	//! \return 64-bit FNV-1a hash of the \a name, the same on all targets.
+	static std::uint64_t hash( const typename Trait::string_t & name )
+	{
+		std::uint64_t h = 14695981039346656037ull;
+
+		for( const auto & ch : name )
+		{
+			h ^= static_cast< std::uint64_t > ( char_code( ch ) );
+			h *= 1099511628211ull;
+		}
+
+		return h;
+	}
+
+	std::size_t operator () ( const typename Trait::string_t & name ) const
+	{
+		return static_cast< std::size_t > ( hash( name ) );
+	}
+}; // struct name_hash_t
+
+
+//
+// name_ptr_hash_t
+//
+
+//! Hash of the tag's name given by pointer.
+template< typename Trait >
+struct name_ptr_hash_t {
+	std::size_t operator () ( const typename Trait::string_t * name ) const
+	{
+		return static_cast< std::size_t > ( name_hash_t< Trait >::hash( *name ) );
+	}
+}; // struct name_ptr_hash_t
+
+
+//
+// name_ptr_equal_t
+//
+
+//! Equality of the tag's names given by pointers.
+template< typename Trait >
+struct name_ptr_equal_t {
+	bool operator () ( const typename Trait::string_t * n1,
+		const typename Trait::string_t * n2 ) const
+	{
+		return ( *n1 == *n2 );
+	}
+}; // struct name_ptr_equal_t
+
+} /* namespace details */
+
+
+//
+// name_table_t
+//
+
+/*!
+	Table of interned names of the tags.
+
+	Each distinct name is stored once and never removed, so tags with
+	equal names share one string and names can be compared by address.
+
+	Every thread looks names up in its own cache first, so the shared
+	table is locked only when the thread meets a name for the first time.
+	The cache keeps only pointers to the names in the shared table.
+*/
+template< typename Trait = string_trait_t >
+class name_table_t final {
+public:
+	//! \return Interned copy of the \a name.
+	static const typename Trait::string_t & intern(
+		const typename Trait::string_t & name )
+	{
+		cache_t & c = cache();
+
+		const auto it = c.find( &name );
+
+		if( it != c.cend() )
+			return **it;
+
+#ifndef CFGFILE_DISABLE_STL
+		// Names live forever, they must not take memory from arena.
+		arena_scope_t no_arena( nullptr );
+#endif
+
+		const typename Trait::string_t * interned = nullptr;
+
+		{
+			std::lock_guard< std::mutex > lock( mutex() );
+
+			interned = &*names().insert( name ).first;
+		}
+
+		c.insert( interned );
+
+		return *interned;
+	}
+
+private:
+	using names_t = std::unordered_set< typename Trait::string_t,
+		details::name_hash_t< Trait > >;
+
+	using cache_t = std::unordered_set< const typename Trait::string_t*,
+		details::name_ptr_hash_t< Trait >, details::name_ptr_equal_t< Trait > >;
+
+	static cache_t & cache()
+	{
+		static thread_local cache_t c;
+
+		return c;
+	}
+
+	static names_t & names()
+	{
+		static names_t n;
+
+		return n;
+	}
+
+	static std::mutex & mutex()
+	{
+		static std::mutex m;
+
+		return m;
+	}
+}; // class name_table_t
+
+} /* namespace cfgfile */
+
+#endif // CFGFILE__NAME_TABLE_HPP__INCLUDED
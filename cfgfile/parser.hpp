@@ -16,20 +16,28 @@
 #include "parser_info.hpp"
 #include "const.hpp"
 #include "string_format.hpp"
+#include "xml_reader.hpp"
 
 // C++ include.
 #include <memory>
 #include <stack>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #if defined( CFGFILE_QT_SUPPORT ) && defined( CFGFILE_XML_SUPPORT )
 // Qt include.
 #include <QDomDocument>
 #include <QDomElement>
+#include <QXmlStreamReader>
 #endif
 
 
 namespace cfgfile {
 
+//! Max amount of strings in a row passed to the tag at once.
+static const std::size_t c_strings_run_size = 256;
+
 namespace details {
 
 //
@@ -41,7 +49,8 @@ template< typename Trait = string_trait_t >
 class parser_base_t {
 public:
 	explicit parser_base_t( tag_t< Trait > & tag )
-		:	m_tag( tag )
+		:	m_tag( &tag )
+		,	m_error( nullptr )
 	{
 	}
 
@@ -52,27 +61,165 @@ public:
 	//! Do parsing.
 	virtual void parse( const typename Trait::string_t & file_name ) = 0;
 
+	/*!
+		Do parsing and store error in the \a error instead of
+		throwing exception.
+
+		\return false on error.
+	*/
+	virtual bool try_parse( const typename Trait::string_t & file_name,
+		error_t< Trait > & error )
+	{
+		error = error_t< Trait >();
+
+		try {
+			parse( file_name );
+		}
+		catch( const exception_t< Trait > & x )
+		{
+			error = x;
+
+			return false;
+		}
+
+		return true;
+	}
+
+	//! Do parsing and add found errors to the \a errors.
+	virtual void validate( const typename Trait::string_t & file_name,
+		std::vector< parse_result_t< Trait > > & errors )
+	{
+		error_t< Trait > error;
+
+		if( !try_parse( file_name, error ) )
+			errors.push_back( parse_result_t< Trait >( error ) );
+	}
+
+	/*!
+		Parse again after the edit of the text parsed before.
+		By default the whole text is parsed.
+
+		\return false on error.
+	*/
+	virtual bool try_reparse( const typename Trait::string_t & file_name,
+		const text_edit_t< Trait > &, error_t< Trait > & error )
+	{
+		m_tag->clear();
+
+		return try_parse( file_name, error );
+	}
+
+	//! Set limits of the parsing.
+	void set_limits( const parse_limits_t & limits )
+	{
+		m_limits = limits;
+	}
+
 protected:
+	//! \return Is error stored in the error sink?
+	bool has_error() const
+	{
+		return ( m_error && m_error->code() != error_code_t::none );
+	}
+
+	/*!
+		Report error. Throws without error sink, else stores
+		the first error in the sink.
+
+		\return false.
+	*/
+	bool fail( error_code_t code, const typename Trait::string_t & tag_name )
+	{
+		if( !m_error )
+			details::throw_error< Trait >( code, tag_name );
+
+		if( !has_error() )
+			*m_error = error_t< Trait >( code, typename Trait::string_t(),
+				0, 0, tag_name, typename Trait::string_t() );
+
+		return false;
+	}
+
+	/*!
+		Report error. Throws without error sink, else stores
+		the first error in the sink.
+
+		\return false.
+	*/
+	bool fail( error_code_t code,
+		const typename Trait::string_t & file_name,
+		typename Trait::pos_t line_number,
+		typename Trait::pos_t column_number,
+		const typename Trait::string_t & tag_name = typename Trait::string_t(),
+		const typename Trait::string_t & token = typename Trait::string_t() )
+	{
+		if( !m_error )
+			details::throw_error< Trait >( code, file_name, line_number,
+				column_number, tag_name, token );
+
+		if( !has_error() )
+			*m_error = error_t< Trait >( code, file_name, line_number,
+				column_number, tag_name, token );
+
+		return false;
+	}
+
+	/*!
+		Check limits before the start of the \a tag at the
+		\a line_number and the \a column_number.
 
-	void check_parser_state_after_parsing()
+		\return false if a limit is exceeded.
+	*/
+	bool check_start_limits( const tag_t< Trait > & tag,
+		const typename Trait::string_t & file_name,
+		typename Trait::pos_t line_number,
+		typename Trait::pos_t column_number )
+	{
+		if( m_limits.m_max_depth && m_stack.size() >= m_limits.m_max_depth )
+			return fail( error_code_t::limit_exceeded, file_name, line_number,
+				column_number, tag.name(), Trait::from_ascii( "depth" ) );
+
+		if( m_limits.m_max_elements &&
+			tag.elements_count() >= m_limits.m_max_elements )
+				return fail( error_code_t::limit_exceeded, file_name,
+					line_number, column_number, tag.name(),
+					Trait::from_ascii( "elements" ) );
+
+		return true;
+	}
+
+	//! \return false if parsing is not finished properly.
+	bool check_parser_state_after_parsing()
 	{
 		if( !m_stack.empty() )
-			throw exception_t< Trait >(
-				Trait::from_ascii( "Unexpected end of file. "
-					"Still unfinished tag \"" ) + m_stack.top()->name() +
-				Trait::from_ascii( "\"." ) );
+			return fail( error_code_t::unfinished_tag, m_stack.top()->name() );
+
+		if( m_tag->is_mandatory() && !m_tag->is_defined() )
+			return fail( error_code_t::undefined_mandatory_tag, m_tag->name() );
+
+		return true;
+	}
+
+	//! Set another tag and forget state of the previous parsing.
+	void reset_state( tag_t< Trait > & tag )
+	{
+		m_tag = &tag;
 
-		if( m_tag.is_mandatory() && !m_tag.is_defined() )
-			throw exception_t< Trait >(
-				Trait::from_ascii( "Undefined mandatory tag: \"" ) +
-				m_tag.name() + Trait::from_ascii( "\"." ) );
+		while( !m_stack.empty() )
+			m_stack.pop();
 	}
 
 protected:
 	//! Tag.
-	tag_t< Trait > & m_tag;
+	tag_t< Trait > * m_tag;
+	//! Parsed source.
+	source_t< Trait > m_source;
 	//! Stack of tags.
 	std::stack< tag_t< Trait > * > m_stack;
+	//! Error sink.
+	error_t< Trait > * m_error;
+	//! Limits.
+	parse_limits_t m_limits;
 }; // class parser_base_t
 
 
@@ -81,15 +228,18 @@ protected:
 //
 
 //! Implementation of parser in cfgfile format.
-template< typename Trait = string_trait_t >
+template< typename Trait = string_trait_t,
+	typename Lex = lexical_analyzer_t< Trait > >
 class parser_conffile_impl_t final
 	:	public parser_base_t< Trait >
 {
 public:
 	parser_conffile_impl_t( tag_t< Trait > & tag,
-		input_stream_t< Trait > & stream )
+		typename Lex::stream_t & stream )
 		:	parser_base_t< Trait >( tag )
 		,	m_lex( stream )
+		,	m_errors( nullptr )
+		,	m_single_tag( false )
 	{
 	}
 
@@ -97,12 +247,218 @@ public:
 	{
 	}
 
+	//! Prepare for parsing into \a tag from the current position of the stream.
+	void reset( tag_t< Trait > & tag )
+	{
+		this->reset_state( tag );
+
+		m_values.clear();
+		m_lex.reset();
+	}
+
 	//! Do parsing.
 	void parse( const typename Trait::string_t & file_name ) override
 	{
-		if( !start_first_tag_parsing() )
+		set_error_sink( nullptr );
+
+		do_parse( file_name );
+	}
+
+	/*!
+		Do parsing without exceptions in the lexer, the parser and the
+		built-in tags and formats. Exceptions thrown by user's tags are
+		caught and stored in the \a error.
+
+		\return false on error.
+	*/
+	bool try_parse( const typename Trait::string_t & file_name,
+		error_t< Trait > & error ) override
+	{
+		error = error_t< Trait >();
+
+		set_error_sink( &error );
+
+		bool ok = false;
+
+		try {
+			ok = do_parse( file_name );
+		}
+		catch( const exception_t< Trait > & x )
+		{
+			error = x;
+		}
+
+		set_error_sink( nullptr );
+
+		return ok;
+	}
+
+	/*!
+		Do parsing and add all found errors to the \a errors.
+
+		On error in the tag the error is stored, the rest of the tag
+		is skipped up to its finish curl brace and parsing goes on.
+		Errors of the lexer stop parsing.
+	*/
+	void validate( const typename Trait::string_t & file_name,
+		std::vector< parse_result_t< Trait > > & errors ) override
+	{
+		error_t< Trait > error;
+
+		set_error_sink( &error );
+		m_errors = &errors;
+
+		do_parse( file_name );
+
+		if( error.code() != error_code_t::none )
+			errors.push_back( parse_result_t< Trait >( error ) );
+
+		m_errors = nullptr;
+		set_error_sink( nullptr );
+	}
+
+	/*!
+		Parse again after the \a edit of the text parsed before, the
+		stream contains the whole text after the edit.
+
+		Only the smallest tag enclosing the edit is parsed, positions
+		of the tags after it are moved. If this tag can't be parsed
+		alone, i.e. the edit changed the structure, the parent is
+		tried, up to parsing of the whole text.
+
+		\return false on error.
+	*/
+	bool try_reparse( const typename Trait::string_t & file_name,
+		const text_edit_t< Trait > & edit, error_t< Trait > & error ) override
+	{
+		tag_t< Trait > & root = *this->m_tag;
+
+		const std::vector< tag_t< Trait > * > path =
+			enclosing_tags( root, edit );
+
+		const typename Trait::pos_t delta = edit.m_new_length - edit.m_length;
+
+		for( auto it = path.rbegin(), last = path.rend(); it != last; ++it )
+		{
+			tag_t< Trait > & tag = **it;
+
+			const typename Trait::pos_t end_offset = tag.end_offset();
+			const typename Trait::pos_t end_line_number = tag.end_line_number();
+			const typename Trait::pos_t end_column_number =
+				tag.end_column_number();
+
+			m_lex.seek( tag.offset(), tag.line_number(), tag.column_number() );
+
+			tag.clear();
+			reset( tag );
+
+			m_single_tag = true;
+
+			const bool ok = try_parse( file_name, error );
+
+			m_single_tag = false;
+
+			if( ok && tag.end_offset() == end_offset + delta )
+			{
+				shift_positions( root, tag, end_offset + 1, delta,
+					end_line_number, tag.end_line_number() - end_line_number,
+					tag.end_column_number() - end_column_number );
+
+				this->reset_state( root );
+
+				return true;
+			}
+		}
+
+		m_lex.seek( 0, 1, 1 );
+
+		root.clear();
+		reset( root );
+
+		return try_parse( file_name, error );
+	}
+
+private:
+	//! \return Does the \a tag enclose the \a edit?
+	static bool encloses( const tag_t< Trait > & tag,
+		const text_edit_t< Trait > & edit )
+	{
+		return ( tag.offset() >= 0 && tag.offset() < edit.m_offset &&
+			edit.m_offset + edit.m_length <= tag.end_offset() );
+	}
+
+	//! \return Tags enclosing the \a edit, from the \a root down.
+	static std::vector< tag_t< Trait > * > enclosing_tags(
+		tag_t< Trait > & root, const text_edit_t< Trait > & edit )
+	{
+		std::vector< tag_t< Trait > * > path;
+
+		tag_t< Trait > * tag = ( encloses( root, edit ) ? &root : nullptr );
+
+		while( tag )
+		{
+			path.push_back( tag );
+
+			tag_t< Trait > * parent = tag;
+
+			tag = nullptr;
+
+			for( tag_t< Trait > * child : parent->children() )
+			{
+				if( encloses( *child, edit ) )
+				{
+					tag = child;
+
+					break;
+				}
+			}
+		}
+
+		return path;
+	}
+
+	//! Move positions of the \a tag and its children, except \a skip.
+	static void shift_positions( tag_t< Trait > & tag,
+		const tag_t< Trait > & skip,
+		typename Trait::pos_t offset,
+		typename Trait::pos_t offset_delta,
+		typename Trait::pos_t line_number,
+		typename Trait::pos_t line_delta,
+		typename Trait::pos_t column_delta )
+	{
+		if( &tag == &skip )
 			return;
 
+		tag.shift_position( offset, offset_delta, line_number, line_delta,
+			column_delta );
+
+		for( tag_t< Trait > * child : tag.children() )
+			shift_positions( *child, skip, offset, offset_delta, line_number,
+				line_delta, column_delta );
+
+		for( std::size_t i = 0, count = tag.elements_count(); i < count; ++i )
+			shift_positions( *tag.element( i ), skip, offset, offset_delta,
+				line_number, line_delta, column_delta );
+	}
+
+	//! Set error sink to the parser, the lexer and the tags.
+	void set_error_sink( error_t< Trait > * error )
+	{
+		this->m_error = error;
+		this->m_source.set_error_sink( error );
+		m_lex.set_error_sink( error );
+	}
+
+	//! Do parsing. \return false on error.
+	bool do_parse( const typename Trait::string_t & file_name )
+	{
+		this->m_source.set_file_name( file_name );
+
+		m_lex.set_limits( this->m_limits );
+
+		if( !start_first_tag_parsing() )
+			return !this->has_error();
+
 		lexeme_t< Trait > lexeme = m_lex.next_lexeme();
 
 		while( !lexeme.is_null() )
@@ -112,25 +468,60 @@ public:
 				switch( lexeme.type() )
 				{
 					case lexeme_type_t::start :
-						start_tag_parsing( *this->m_stack.top(),
-							this->m_stack.top()->children() );
+					{
+						lexeme = m_lex.next_lexeme();
+
+						if( !start_tag_parsing( lexeme, *this->m_stack.top(),
+							this->m_stack.top()->children() ) )
+						{
+							if( !recover( lexeme ) )
+								return false;
+
+							skip_tag( lexeme );
+
+							continue;
+						}
+					}
 						break;
 
 					case lexeme_type_t::string :
-						this->m_stack.top()->on_string( parser_info_t< Trait >(
-								file_name,
-								m_lex.line_number(),
-								m_lex.column_number() ),
-							lexeme.value() );
-						break;
+					{
+						if( !parse_strings( lexeme ) )
+						{
+							if( !recover( lexeme ) )
+								return false;
+
+							if( skip_tag( lexeme ) )
+							{
+								this->m_stack.top()->set_defined();
+								this->m_stack.pop();
+							}
+						}
+					}
+						continue;
 
 					case lexeme_type_t::finish :
 					{
-						this->m_stack.top()->on_finish( parser_info_t< Trait >(
-							file_name,
-							m_lex.line_number(),
-							m_lex.column_number() ) );
+						tag_t< Trait > * tag = this->m_stack.top();
+
+						const parser_info_t< Trait > info( this->m_source,
+							m_lex.line_number(), m_lex.column_number(),
+							m_lex.offset() );
+
+						if( !call_tag( [&] () { tag->on_finish( info ); } ) )
+						{
+							if( !recover( lexeme ) )
+								return false;
+
+							tag->set_defined();
+						}
+
+						tag->set_end_position( info );
+
 						this->m_stack.pop();
+
+						if( m_single_tag && this->m_stack.empty() )
+							return this->check_parser_state_after_parsing();
 					}
 						break;
 
@@ -139,216 +530,407 @@ public:
 				}
 			}
 			else
-				throw exception_t< Trait >(
-					Trait::from_ascii( "Unexpected content. "
-						"We've finished parsing, but we've got this: \"" ) +
-					lexeme.value() + Trait::from_ascii( "\". " ) +
-					Trait::from_ascii( "In file \"" ) + file_name +
-					Trait::from_ascii( "\" on line " ) +
-					Trait::to_string( m_lex.line_number() ) +
-					Trait::from_ascii( "." ) );
-
+				return this->fail( error_code_t::unexpected_content, file_name,
+					m_lex.line_number(), m_lex.column_number(),
+					typename Trait::string_t(), lexeme.value() );
 
 			lexeme = m_lex.next_lexeme();
 		}
 
-		this->check_parser_state_after_parsing();
+		if( this->has_error() )
+			return false;
+
+		return this->check_parser_state_after_parsing();
 	}
 
-private:
+	/*!
+		Pass strings in a row, starting with the \a lexeme, to the
+		current tag. On return the \a lexeme is the next lexeme
+		after strings.
 
-	bool start_first_tag_parsing()
+		\return false on error.
+	*/
+	bool parse_strings( lexeme_t< Trait > & lexeme )
 	{
-		lexeme_t< Trait > lexeme = m_lex.next_lexeme();
-
-		if( this->m_tag.is_mandatory() && lexeme.type() == lexeme_type_t::null )
-			throw exception_t< Trait >(
-				Trait::from_ascii( "Unexpected end of file. "
-					"Undefined mandatory tag \"" ) + this->m_tag.name() +
-				Trait::from_ascii( "\". In file \"" ) +
-				m_lex.input_stream().file_name() +
-				Trait::from_ascii( "\" on line " ) +
-				Trait::to_string( m_lex.line_number() ) +
-				Trait::from_ascii( "." ) );
-		else if( !this->m_tag.is_mandatory() &&
-			lexeme.type() == lexeme_type_t::null )
-				return false;
-		else if( lexeme.type() != lexeme_type_t::start )
-			throw exception_t< Trait >(
-				Trait::from_ascii( "Expected start curl brace, "
-					"but we've got \"" ) + lexeme.value() +
-				Trait::from_ascii( "\". In file \"" ) +
-				m_lex.input_stream().file_name() +
-				Trait::from_ascii( "\" on line " ) +
-				Trait::to_string( m_lex.line_number() ) +
-				Trait::from_ascii( "." ) );
-
-		lexeme = m_lex.next_lexeme();
+		m_values.clear();
 
-		if( !start_tag_parsing( lexeme, this->m_tag ) )
-			throw exception_t< Trait >(
-				Trait::from_ascii( "Unexpected tag name. "
-					"We expected \"" ) + this->m_tag.name() +
-				Trait::from_ascii( "\", but we've got \"" ) + lexeme.value() +
-				Trait::from_ascii( "\". In file \"" ) +
-				m_lex.input_stream().file_name() +
-				Trait::from_ascii( "\" on line " ) +
-				Trait::to_string( m_lex.line_number() ) +
-				Trait::from_ascii( "." ) );
-
-		return true;
-	}
+		// Values of the tag are in one row, before child tags.
+		std::size_t count = 0;
 
-	bool start_tag_parsing( const lexeme_t< Trait > & lexeme,
-		tag_t< Trait > & tag )
-	{
-		if( lexeme.type() == lexeme_type_t::start )
-			throw exception_t< Trait >(
-				Trait::from_ascii( "Unexpected start curl brace. "
-					"We expected tag name, but we've got start curl brace. "
-					"In file \"" ) + m_lex.input_stream().file_name() +
-				Trait::from_ascii( "\" on line " ) +
-				Trait::to_string( m_lex.line_number() ) +
-				Trait::from_ascii( "." ) );
-		else if( lexeme.type() == lexeme_type_t::finish )
-			throw exception_t< Trait >(
-				Trait::from_ascii( "Unexpected finish curl brace. "
-					"We expected tag name, but we've got finish curl brace. "
-					"In file \"" ) + m_lex.input_stream().file_name() +
-				Trait::from_ascii( "\" on line " ) +
-				Trait::to_string( m_lex.line_number() ) +
-				Trait::from_ascii( "." ) );
-		else if( lexeme.type() == lexeme_type_t::null )
-			throw exception_t< Trait >(
-				Trait::from_ascii( "Unexpected end of file. "
-					"In file \"" ) + m_lex.input_stream().file_name() +
-				Trait::from_ascii( "\" on line " ) +
-				Trait::to_string( m_lex.line_number() ) +
-				Trait::from_ascii( "." ) );
-		else if( tag.name() == lexeme.value() )
+		while( lexeme.type() == lexeme_type_t::string )
 		{
-			this->m_stack.push( &tag );
+			if( this->m_limits.m_max_values &&
+				++count > this->m_limits.m_max_values )
+					return this->fail( error_code_t::limit_exceeded,
+						m_lex.file_name(), m_lex.line_number(),
+						m_lex.column_number(), this->m_stack.top()->name(),
+						Trait::from_ascii( "values" ) );
 
-			tag.on_start( parser_info_t< Trait >(
-				m_lex.input_stream().file_name(),
-				m_lex.line_number(),
-				m_lex.column_number() ) );
+			m_values.push_back( { lexeme.take_value(),
+				m_lex.line_number(), m_lex.column_number() } );
 
-			return true;
+			lexeme = next_lexeme_after_string();
+
+			if( m_values.size() == c_strings_run_size && !flush_strings() )
+				return false;
 		}
 
-		return false;
+		return flush_strings();
 	}
 
-	void start_tag_parsing( const tag_t< Trait > & parent,
-		const typename tag_t< Trait >::child_tags_list_t & list )
+	/*!
+		\return Next lexeme after the string. On lexical error the
+		collected strings are passed to the tag first, so an error in
+		them is reported before the lexical one, that is later in the
+		file. In validation mode both errors are reported.
+	*/
+	lexeme_t< Trait > next_lexeme_after_string()
 	{
-		lexeme_t< Trait > lexeme = m_lex.next_lexeme();
+		lexeme_t< Trait > lexeme;
+
+		try {
+			lexeme = m_lex.next_lexeme();
+		}
+		catch( const exception_t< Trait > & )
+		{
+			flush_strings();
 
-		bool tag_found = false;
+			throw;
+		}
 
-		for( tag_t< Trait > * tag : list )
+		if( this->has_error() )
 		{
-			if( start_tag_parsing( lexeme, *tag ) )
+			const error_t< Trait > error = *this->m_error;
+
+			*this->m_error = error_t< Trait >();
+
+			if( !flush_strings() )
 			{
-				tag_found = true;
+				if( !m_errors )
+					return lexeme;
 
-				break;
+				m_errors->push_back( parse_result_t< Trait >( *this->m_error ) );
 			}
+
+			*this->m_error = error;
 		}
 
-		if( !tag_found )
-			throw exception_t< Trait >(
-				Trait::from_ascii( "Unexpected tag name. "
-					"We expected one child tag of tag \"" ) +
-				parent.name() +
-				Trait::from_ascii( "\", but we've got \"" ) + lexeme.value() +
-				Trait::from_ascii( "\". In file \"" ) +
-				m_lex.input_stream().file_name() +
-				Trait::from_ascii( "\" on line " ) +
-				Trait::to_string( m_lex.line_number() ) +
-				Trait::from_ascii( "." ) );
+		return lexeme;
 	}
 
-private:
-	//! Lex.
-	lexical_analyzer_t< Trait > m_lex;
-}; // class parser_conffile_impl_t
+	//! Pass collected strings to the current tag. \return false on error.
+	bool flush_strings()
+	{
+		if( this->has_error() )
+			return false;
 
-#if defined( CFGFILE_QT_SUPPORT ) && defined( CFGFILE_XML_SUPPORT )
+		if( m_values.empty() )
+			return true;
 
-//
-// parser_dom_impl_t
-//
+		tag_t< Trait > * tag = this->m_stack.top();
 
-//! Implementation of parser in XML format.
-template< typename Trait = qstring_trait_t >
-class parser_dom_impl_t final
-	:	public parser_base_t< Trait >
-{
-public:
-	parser_dom_impl_t( tag_t< Trait > & tag, const QDomDocument & dom )
-		:	parser_base_t< Trait >( tag )
-		,	m_dom( dom )
-	{
-	}
+		const bool ok = call_tag( [&] () {
+			tag->on_strings( parser_info_t< Trait >(
+					this->m_source,
+					m_values.front().m_line_number,
+					m_values.front().m_column_number ),
+				m_values ); } );
 
-	~parser_dom_impl_t()
-	{
-	}
+		m_values.clear();
 
-	//! Do parsing.
-	void parse( const typename Trait::string_t & file_name ) override
-	{
-		QDomElement element = m_dom.documentElement();
+		return ok;
+	}
 
-		if( element.isNull() && this->m_tag.is_mandatory() )
-			throw exception_t< Trait >(
-				Trait::from_ascii( "Unexpected end of file. "
-					"Undefined mandatory tag \"" ) + this->m_tag.name() +
-				Trait::from_ascii( "\". In file \"" ) + file_name +
-				Trait::from_ascii( "\" on line " ) +
-				Trait::to_string( element.lineNumber() ) +
-				Trait::from_ascii( "." ) );
+	/*!
+		Call the \a callback of the tag. Built-in tags report errors
+		to the error sink. In validation mode exception thrown by the
+		user's tag is stored in the error sink too.
 
-		if( !element.isNull() )
+		\return false on error.
+	*/
+	template< typename Callback >
+	bool call_tag( Callback callback )
+	{
+		if( !m_errors )
 		{
-			if( element.tagName() != this->m_tag.name() )
-				throw exception_t< Trait >(
-					Trait::from_ascii( "Unexpected tag name. "
-						"We expected \"" ) + this->m_tag.name() +
-					Trait::from_ascii( "\", but we've got \"" ) +
-					typename Trait::string_t( element.tagName() ) +
-					Trait::from_ascii( "\". In file \"" ) + file_name +
-					Trait::from_ascii( "\" on line " ) +
-					Trait::to_string( element.lineNumber() ) +
-					Trait::from_ascii( "." ) );
-
-			this->m_stack.push( &this->m_tag );
-
-			this->m_tag.on_start( parser_info_t< Trait >( file_name,
-				element.lineNumber(),
-				element.columnNumber() ) );
-		}
+			callback();
 
-		parse_tag( element, file_name );
+			return !this->has_error();
+		}
 
-		if( !element.isNull() )
+		try {
+			callback();
+		}
+		catch( const exception_t< Trait > & x )
 		{
-			this->m_stack.top()->on_finish( parser_info_t< Trait >(
-				file_name,
-				element.lineNumber(),
-				element.columnNumber() ) );
+			if( !this->has_error() )
+				*this->m_error = x;
 
-			this->m_stack.pop();
+			return false;
 		}
 
-		this->check_parser_state_after_parsing();
+		return !this->has_error();
 	}
 
-private:
-	//! Parse tag.
-	void parse_tag( const QDomElement & e,
+	/*!
+		In validation mode move the error from the error sink to the
+		list of errors. The \a lexeme is the current one, null lexeme
+		means end of file or error in the lexer.
+
+		\return false if parsing can't be continued.
+	*/
+	bool recover( const lexeme_t< Trait > & lexeme )
+	{
+		if( !m_errors || lexeme.is_null() )
+			return false;
+
+		m_errors->push_back( parse_result_t< Trait >( *this->m_error ) );
+
+		*this->m_error = error_t< Trait >();
+
+		return true;
+	}
+
+	/*!
+		Skip lexemes, starting with the \a lexeme, up to the finish
+		curl brace of the tag which start curl brace is already read.
+		On return the \a lexeme is the next lexeme after the tag.
+
+		\return false if end of file reached.
+	*/
+	bool skip_tag( lexeme_t< Trait > & lexeme )
+	{
+		std::size_t depth = 1;
+
+		while( !lexeme.is_null() )
+		{
+			if( lexeme.type() == lexeme_type_t::start )
+				++depth;
+			else if( lexeme.type() == lexeme_type_t::finish && --depth == 0 )
+			{
+				lexeme = m_lex.next_lexeme();
+
+				return true;
+			}
+
+			lexeme = m_lex.next_lexeme();
+		}
+
+		return false;
+	}
+
+	/*!
+		In single tag mode the start curl brace is already read.
+
+		\return false if there is nothing to parse or on error.
+	*/
+	bool start_first_tag_parsing()
+	{
+		lexeme_t< Trait > lexeme;
+
+		if( !m_single_tag )
+		{
+			lexeme = m_lex.next_lexeme();
+
+			if( this->m_tag->is_mandatory() &&
+				lexeme.type() == lexeme_type_t::null )
+					return this->fail(
+						error_code_t::end_of_file_instead_of_mandatory_tag,
+						m_lex.file_name(), m_lex.line_number(),
+						m_lex.column_number(), this->m_tag->name() );
+			else if( !this->m_tag->is_mandatory() &&
+				lexeme.type() == lexeme_type_t::null )
+					return false;
+			else if( lexeme.type() != lexeme_type_t::start )
+				return this->fail( error_code_t::expected_start_curl_brace,
+					m_lex.file_name(), m_lex.line_number(),
+					m_lex.column_number(), typename Trait::string_t(),
+					lexeme.value() );
+		}
+
+		lexeme = m_lex.next_lexeme();
+
+		if( !start_tag_parsing( lexeme, *this->m_tag ) )
+			return this->fail( error_code_t::unexpected_tag_name,
+				m_lex.file_name(), m_lex.line_number(), m_lex.column_number(),
+				this->m_tag->name(), lexeme.value() );
+
+		return true;
+	}
+
+	//! \return false if the \a lexeme is not the name of the \a tag or on error.
+	bool start_tag_parsing( const lexeme_t< Trait > & lexeme,
+		tag_t< Trait > & tag )
+	{
+		if( lexeme.type() == lexeme_type_t::start )
+			return this->fail( error_code_t::unexpected_start_curl_brace,
+				m_lex.file_name(), m_lex.line_number(), m_lex.column_number() );
+		else if( lexeme.type() == lexeme_type_t::finish )
+			return this->fail( error_code_t::unexpected_finish_curl_brace,
+				m_lex.file_name(), m_lex.line_number(), m_lex.column_number() );
+		else if( lexeme.type() == lexeme_type_t::null )
+			return this->fail( error_code_t::unexpected_end_of_file,
+				m_lex.file_name(), m_lex.line_number(), m_lex.column_number() );
+		else if( tag.name() == lexeme.value() )
+		{
+			if( !this->check_start_limits( tag, m_lex.file_name(),
+				m_lex.line_number(), m_lex.column_number() ) )
+					return false;
+
+			this->m_stack.push( &tag );
+
+			const bool ok = call_tag( [&] () {
+				tag.on_start( parser_info_t< Trait >(
+					this->m_source,
+					m_lex.line_number(),
+					m_lex.column_number(),
+					m_lex.offset() ) ); } );
+
+			if( !ok )
+			{
+				// The error is reported, the tag will be skipped.
+				tag.set_defined();
+				this->m_stack.pop();
+			}
+
+			return ok;
+		}
+
+		return false;
+	}
+
+	//! \return false if the \a lexeme is not a name of child tag or on error.
+	bool start_tag_parsing( const lexeme_t< Trait > & lexeme,
+		const tag_t< Trait > & parent,
+		const typename tag_t< Trait >::child_tags_list_t & list )
+	{
+		for( tag_t< Trait > * tag : list )
+		{
+			if( start_tag_parsing( lexeme, *tag ) )
+				return true;
+			else if( this->has_error() )
+				return false;
+		}
+
+		return this->fail( error_code_t::unexpected_child_tag_name,
+			m_lex.file_name(), m_lex.line_number(), m_lex.column_number(),
+			parent.name(), lexeme.value() );
+	}
+
+private:
+	//! Lex.
+	Lex m_lex;
+	//! Strings in a row.
+	std::vector< parsed_value_t< Trait > > m_values;
+	//! Found errors in validation mode.
+	std::vector< parse_result_t< Trait > > * m_errors;
+	//! Parse only one tag, which start curl brace is already read.
+	bool m_single_tag;
+}; // class parser_conffile_impl_t
+
+#if defined( CFGFILE_QT_SUPPORT ) && defined( CFGFILE_XML_SUPPORT )
+
+//
+// xml_attribute_number
+//
+
+/*!
+	\return Number of the value in the name of the attribute "a1",
+	"a2", ..., or 0 if the name isn't such or the number is greater
+	than \a count.
+*/
+inline int xml_attribute_number( QStringView name, int count )
+{
+	if( name.size() < 2 || name.at( 0 ) != QLatin1Char( 'a' ) ||
+		name.at( 1 ) == QLatin1Char( '0' ) )
+			return 0;
+
+	int number = 0;
+
+	for( qsizetype i = 1; i < name.size(); ++i )
+	{
+		const int digit = name.at( i ).digitValue();
+
+		if( digit < 0 )
+			return 0;
+
+		number = number * 10 + digit;
+
+		if( number > count )
+			return 0;
+	}
+
+	return number;
+}
+
+
+//
+// parser_dom_impl_t
+//
+
+//! Implementation of parser in XML format.
+template< typename Trait = qstring_trait_t >
+class parser_dom_impl_t final
+	:	public parser_base_t< Trait >
+{
+public:
+	parser_dom_impl_t( tag_t< Trait > & tag, const QDomDocument & dom )
+		:	parser_base_t< Trait >( tag )
+		,	m_dom( dom )
+	{
+	}
+
+	~parser_dom_impl_t()
+	{
+	}
+
+	//! Do parsing.
+	void parse( const typename Trait::string_t & file_name ) override
+	{
+		this->m_source.set_file_name( file_name );
+
+		QDomElement element = m_dom.documentElement();
+
+		if( element.isNull() && this->m_tag->is_mandatory() )
+			details::throw_error< Trait >(
+				error_code_t::end_of_file_instead_of_mandatory_tag, file_name,
+				element.lineNumber(), element.columnNumber(),
+				this->m_tag->name() );
+
+		if( !element.isNull() )
+		{
+			if( element.tagName() != this->m_tag->name() )
+				details::throw_error< Trait >(
+					error_code_t::unexpected_tag_name, file_name,
+					element.lineNumber(), element.columnNumber(),
+					this->m_tag->name(),
+					typename Trait::string_t( element.tagName() ) );
+
+			this->m_stack.push( this->m_tag );
+
+			this->m_tag->on_start( parser_info_t< Trait >( this->m_source,
+				element.lineNumber(),
+				element.columnNumber() ) );
+		}
+
+		parse_tag( element, file_name );
+
+		if( !element.isNull() )
+		{
+			this->m_stack.top()->on_finish( parser_info_t< Trait >(
+				this->m_source,
+				element.lineNumber(),
+				element.columnNumber() ) );
+
+			this->m_stack.pop();
+		}
+
+		this->check_parser_state_after_parsing();
+	}
+
+private:
+	//! Parse tag.
+	void parse_tag( const QDomElement & e,
 		const typename Trait::string_t & file_name )
 	{
 		for( QDomNode n = e.firstChild(); !n.isNull();
@@ -362,38 +944,43 @@ private:
 					this->m_stack.top()->children() );
 
 				if( !tag )
-					throw exception_t< Trait >(
-						Trait::from_ascii( "Unexpected tag name. "
-							"We expected one child tag of tag \"" ) +
-						this->m_stack.top()->name() +
-						Trait::from_ascii( "\", but we've got \"" ) +
-						typename Trait::string_t( child.tagName() ) +
-						Trait::from_ascii( "\". In file \"" ) + file_name +
-						Trait::from_ascii( "\" on line " ) +
-						Trait::to_string( child.lineNumber() ) +
-						Trait::from_ascii( "." ) );
+					details::throw_error< Trait >(
+						error_code_t::unexpected_child_tag_name, file_name,
+						child.lineNumber(), child.columnNumber(),
+						this->m_stack.top()->name(),
+						typename Trait::string_t( child.tagName() ) );
 
 				this->m_stack.push( tag );
 
-				tag->on_start( parser_info_t< Trait >( file_name,
+				tag->on_start( parser_info_t< Trait >( this->m_source,
 					child.lineNumber(),
 					child.columnNumber() ) );
 
 				const QDomNamedNodeMap attributes = child.attributes();
+				const int count = attributes.count();
 
-				for( int i = 1; i <= attributes.count(); ++i )
+				// Attributes placed by the numbers in the names in one pass.
+				std::vector< QDomAttr > values( count );
+
+				for( int i = 0; i < count; ++i )
 				{
-					const QDomAttr attr = attributes.namedItem(
-						QString( "a" ) + QString::number( i ) ).toAttr();
+					const QDomAttr attr = attributes.item( i ).toAttr();
+
+					const int number = xml_attribute_number( attr.name(), count );
 
+					if( number > 0 )
+						values[ number - 1 ] = attr;
+				}
+
+				for( const QDomAttr & attr : values )
+				{
 					if( !attr.isNull() )
 					{
+						const typename Trait::string_t raw = attr.value();
 						typename Trait::string_t value;
 
 						try {
-							value = from_cfgfile_format< Trait >( attr.value()
-								.prepend( const_t< Trait >::c_quotes )
-								.append( const_t< Trait >::c_quotes ) );
+							value = unescape< Trait >( raw, 0, raw.length() );
 						}
 						catch( const exception_t< Trait > & x )
 						{
@@ -405,7 +992,7 @@ private:
 						}
 
 						tag->on_string( parser_info_t< Trait >(
-								file_name,
+								this->m_source,
 								attr.lineNumber(),
 								attr.columnNumber() ),
 							value );
@@ -415,7 +1002,7 @@ private:
 				parse_tag( child, file_name );
 
 				tag->on_finish( parser_info_t< Trait >(
-					file_name,
+					this->m_source,
 					child.lineNumber(),
 					child.columnNumber() ) );
 
@@ -445,22 +1032,17 @@ private:
 					}
 
 					this->m_stack.top()->on_string( parser_info_t< Trait >(
-							file_name,
+							this->m_source,
 							text.lineNumber(),
 							text.columnNumber() ),
 						value );
 				}
 				else
-					throw exception_t< Trait >(
-						Trait::from_ascii( "Unexpected tag name. "
-							"We expected one child tag of tag \"" ) +
-						this->m_stack.top()->name() +
-						Trait::from_ascii( "\", but we've got \"" ) +
-						typename Trait::string_t( n.nodeName() ) +
-						Trait::from_ascii( "\". In file \"" ) + file_name +
-						Trait::from_ascii( "\" on line " ) +
-						Trait::to_string( n.lineNumber() ) +
-						Trait::from_ascii( "." ) );
+					details::throw_error< Trait >(
+						error_code_t::unexpected_child_tag_name, file_name,
+						n.lineNumber(), n.columnNumber(),
+						this->m_stack.top()->name(),
+						typename Trait::string_t( n.nodeName() ) );
 			}
 		}
 	}
@@ -484,6 +1066,570 @@ private:
 
 #endif
 
+
+//
+// xml_attribute_number
+//
+
+/*!
+	\return Number of the value in the name of the attribute "a1",
+	"a2", ..., or 0 if the name isn't such or the number is greater
+	than \a count.
+*/
+template< typename Trait >
+int xml_attribute_number( const typename Trait::string_t & name, int count )
+{
+	if( name.size() < 2 || name[ 0 ] != Trait::from_ascii( 'a' ) ||
+		name[ 1 ] == Trait::from_ascii( '0' ) )
+			return 0;
+
+	int number = 0;
+
+	for( std::size_t i = 1; i < static_cast< std::size_t > ( name.size() ); ++i )
+	{
+		const std::size_t c = char_code( name[ i ] );
+
+		if( c < '0' || c > '9' )
+			return 0;
+
+		number = number * 10 + static_cast< int > ( c - '0' );
+
+		if( number > count )
+			return 0;
+	}
+
+	return number;
+}
+
+
+//
+// xml_reader_adapter_t
+//
+
+//! Adapter of xml_reader_t for parser_xml_impl_t.
+template< typename Trait >
+class xml_reader_adapter_t final {
+public:
+	//! Type of the reader.
+	typedef xml_reader_t< Trait > reader_t;
+
+	explicit xml_reader_adapter_t( reader_t & reader )
+		:	m_reader( reader )
+	{
+	}
+
+	//! Start reading of the \a file_name with the \a limits.
+	void start( const typename Trait::string_t &, const parse_limits_t & limits )
+	{
+		m_reader.set_limits( limits );
+	}
+
+	//! Read next token, \throw exception_t< Trait > if XML is malformed.
+	xml_token_type_t read_next()
+	{
+		return m_reader.read_next();
+	}
+
+	/*!
+		Read XML up to the end.
+
+		\throw exception_t< Trait > if XML is malformed.
+	*/
+	void read_to_end( const typename Trait::string_t & )
+	{
+		if( !m_reader.has_error() )
+		{
+			while( m_reader.read_next() != xml_token_type_t::end_of_document )
+			{
+			}
+		}
+	}
+
+	//! \return Name of the element or target of processing instruction.
+	const typename Trait::string_t & name() const
+	{
+		return m_reader.name();
+	}
+
+	//! \return Text.
+	const typename Trait::string_t & text() const
+	{
+		return m_reader.text();
+	}
+
+	//! \return Is text only of white spaces?
+	bool is_whitespace() const
+	{
+		return m_reader.is_whitespace();
+	}
+
+	//! \return Amount of attributes.
+	int attributes_count() const
+	{
+		return static_cast< int > ( m_reader.attributes_count() );
+	}
+
+	//! \return Number in the name of the attribute with the \a index.
+	int attribute_number( int index, int count ) const
+	{
+		return xml_attribute_number< Trait >(
+			m_reader.attribute( static_cast< std::size_t > ( index ) ).m_name,
+			count );
+	}
+
+	//! \return Value of the attribute with the \a index.
+	const typename Trait::string_t & attribute_value( int index ) const
+	{
+		return m_reader.attribute( static_cast< std::size_t > ( index ) ).m_value;
+	}
+
+	//! \return Position of values of the attributes of the element at \a pos.
+	static typename Trait::pos_t attribute_pos( typename Trait::pos_t pos )
+	{
+		return pos;
+	}
+
+	//! \return Line number.
+	typename Trait::pos_t line_number() const
+	{
+		return m_reader.line_number();
+	}
+
+	//! \return Column number.
+	typename Trait::pos_t column_number() const
+	{
+		return m_reader.column_number();
+	}
+
+private:
+	//! Reader.
+	reader_t & m_reader;
+}; // class xml_reader_adapter_t
+
+
+#if defined( CFGFILE_QT_SUPPORT ) && defined( CFGFILE_XML_SUPPORT )
+
+//
+// qxml_reader_adapter_t
+//
+
+//! Adapter of QXmlStreamReader for parser_xml_impl_t.
+template< typename Trait >
+class qxml_reader_adapter_t final {
+public:
+	//! Type of the reader.
+	typedef QXmlStreamReader reader_t;
+
+	explicit qxml_reader_adapter_t( reader_t & reader )
+		:	m_reader( reader )
+	{
+	}
+
+	//! Start reading of the \a file_name with the \a limits.
+	void start( const typename Trait::string_t & file_name,
+		const parse_limits_t & limits )
+	{
+		m_file_name = file_name;
+		m_limits = limits;
+	}
+
+	/*!
+		Read next token, malformed XML ends the document.
+
+		QXmlStreamReader reads by itself, so limits are checked
+		after each token.
+
+		\throw exception_t< Trait > if a limit is exceeded.
+	*/
+	xml_token_type_t read_next()
+	{
+		while( !m_reader.atEnd() )
+		{
+			const QXmlStreamReader::TokenType token = m_reader.readNext();
+
+			if( m_limits.m_max_size &&
+				m_reader.characterOffset() >
+					static_cast< qint64 > ( m_limits.m_max_size ) )
+						fail_limit( "size" );
+
+			switch( token )
+			{
+				case QXmlStreamReader::StartElement :
+				{
+					m_attributes = m_reader.attributes();
+
+					check_length( m_reader.name().size() );
+
+					for( const QXmlStreamAttribute & attr : m_attributes )
+						check_length( attr.value().size() );
+				}
+					return xml_token_type_t::start_element;
+
+				case QXmlStreamReader::EndElement :
+					return xml_token_type_t::end_element;
+
+				case QXmlStreamReader::Characters :
+				{
+					check_length( m_reader.text().size() );
+				}
+					return xml_token_type_t::characters;
+
+				case QXmlStreamReader::ProcessingInstruction :
+					return xml_token_type_t::processing_instruction;
+
+				default :
+					break;
+			}
+		}
+
+		return xml_token_type_t::end_of_document;
+	}
+
+	/*!
+		Read XML up to the end.
+
+		\throw exception_t< Trait > if XML is malformed.
+	*/
+	void read_to_end( const typename Trait::string_t & file_name )
+	{
+		while( !m_reader.atEnd() )
+			m_reader.readNext();
+
+		if( m_reader.hasError() )
+			throw exception_t< Trait >( QString( "Unable to parse XML "
+				"from file: \"%1\". \"%2\" On line %3, column %4." )
+					.arg( file_name )
+					.arg( m_reader.errorString() )
+					.arg( QString::number( m_reader.lineNumber() ) )
+					.arg( QString::number( m_reader.columnNumber() ) ) );
+	}
+
+	//! \return Name of the element or target of processing instruction.
+	typename Trait::string_t name() const
+	{
+		if( m_reader.isProcessingInstruction() )
+			return m_reader.processingInstructionTarget().toString();
+
+		return m_reader.name().toString();
+	}
+
+	//! \return Text.
+	typename Trait::string_t text() const
+	{
+		return m_reader.text().toString();
+	}
+
+	//! \return Is text only of white spaces?
+	bool is_whitespace() const
+	{
+		return m_reader.isWhitespace();
+	}
+
+	//! \return Amount of attributes.
+	int attributes_count() const
+	{
+		return static_cast< int > ( m_attributes.size() );
+	}
+
+	//! \return Number in the name of the attribute with the \a index.
+	int attribute_number( int index, int count ) const
+	{
+		return xml_attribute_number( m_attributes.at( index ).name(), count );
+	}
+
+	//! \return Value of the attribute with the \a index.
+	typename Trait::string_t attribute_value( int index ) const
+	{
+		return m_attributes.at( index ).value().toString();
+	}
+
+	/*!
+		\return Position of values of the attributes, -1 like in DOM,
+		where attributes have no position.
+	*/
+	static typename Trait::pos_t attribute_pos( typename Trait::pos_t )
+	{
+		return -1;
+	}
+
+	//! \return Line number.
+	typename Trait::pos_t line_number() const
+	{
+		return static_cast< typename Trait::pos_t > ( m_reader.lineNumber() );
+	}
+
+	//! \return Column number.
+	typename Trait::pos_t column_number() const
+	{
+		return static_cast< typename Trait::pos_t > ( m_reader.columnNumber() );
+	}
+
+private:
+	//! Throw exception on exceeded limit with the \a name.
+	CFGFILE_COLD void fail_limit( const char * name )
+	{
+		details::throw_error< Trait >( error_code_t::limit_exceeded,
+			m_file_name, line_number(), column_number(),
+			typename Trait::string_t(), Trait::from_ascii( name ) );
+	}
+
+	//! Check the \a length of the lexeme.
+	void check_length( qsizetype length )
+	{
+		if( m_limits.m_max_lexeme_length &&
+			static_cast< std::size_t > ( length ) > m_limits.m_max_lexeme_length )
+				fail_limit( "lexeme length" );
+	}
+
+private:
+	//! Reader.
+	reader_t & m_reader;
+	//! Attributes of the current element.
+	QXmlStreamAttributes m_attributes;
+	//! File name.
+	typename Trait::string_t m_file_name;
+	//! Limits.
+	parse_limits_t m_limits;
+}; // class qxml_reader_adapter_t
+
+#endif
+
+
+//
+// parser_xml_impl_t
+//
+
+/*!
+	Implementation of parser in XML format without DOM.
+
+	Tags get callbacks while XML is read with the \a Reader adapter of
+	xml_reader_t or QXmlStreamReader, only the stack of the open tags
+	is kept in memory. Tags and their values get position of the start
+	of the element, like with DOM. Values of attributes get position
+	from Reader::attribute_pos().
+*/
+template< typename Trait, typename Reader >
+class parser_xml_impl_t final
+	:	public parser_base_t< Trait >
+{
+public:
+	parser_xml_impl_t( tag_t< Trait > & tag,
+		typename Reader::reader_t & reader )
+		:	parser_base_t< Trait >( tag )
+		,	m_reader( reader )
+	{
+	}
+
+	~parser_xml_impl_t()
+	{
+	}
+
+	//! Do parsing.
+	void parse( const typename Trait::string_t & file_name ) override
+	{
+		this->m_source.set_file_name( file_name );
+
+		m_reader.start( file_name, this->m_limits );
+
+		try {
+			read( file_name );
+		}
+		catch( const exception_t< Trait > & x )
+		{
+			// Malformed XML is reported before errors of the tags,
+			// but exceeded limit stops reading of untrusted input at once.
+			if( x.code() != error_code_t::limit_exceeded )
+				m_reader.read_to_end( file_name );
+
+			throw;
+		}
+
+		m_reader.read_to_end( file_name );
+
+		this->check_parser_state_after_parsing();
+	}
+
+private:
+	//! Read XML up to the end.
+	void read( const typename Trait::string_t & file_name )
+	{
+		for( xml_token_type_t token = m_reader.read_next();
+			token != xml_token_type_t::end_of_document;
+			token = m_reader.read_next() )
+		{
+			switch( token )
+			{
+				case xml_token_type_t::start_element :
+					start_element( file_name );
+					break;
+
+				case xml_token_type_t::end_element :
+					finish_element();
+					break;
+
+				case xml_token_type_t::characters :
+				{
+					if( !m_reader.is_whitespace() && !this->m_stack.empty() )
+						characters( file_name );
+				}
+					break;
+
+				case xml_token_type_t::processing_instruction :
+				{
+					if( !this->m_stack.empty() )
+						details::throw_error< Trait >(
+							error_code_t::unexpected_child_tag_name, file_name,
+							m_reader.line_number(), m_reader.column_number(),
+							this->m_stack.top()->name(), m_reader.name() );
+				}
+					break;
+
+				default :
+					break;
+			}
+		}
+	}
+
+	//! Start element.
+	void start_element( const typename Trait::string_t & file_name )
+	{
+		const typename Trait::string_t name = m_reader.name();
+		const typename Trait::pos_t line = m_reader.line_number();
+		const typename Trait::pos_t column = m_reader.column_number();
+
+		tag_t< Trait > * tag = nullptr;
+
+		if( this->m_stack.empty() )
+		{
+			if( !( name == this->m_tag->name() ) )
+				details::throw_error< Trait >(
+					error_code_t::unexpected_tag_name, file_name,
+					line, column, this->m_tag->name(), name );
+
+			tag = this->m_tag;
+		}
+		else
+		{
+			tag = find_tag( name, this->m_stack.top()->children() );
+
+			if( !tag )
+				details::throw_error< Trait >(
+					error_code_t::unexpected_child_tag_name, file_name,
+					line, column, this->m_stack.top()->name(), name );
+		}
+
+		this->check_start_limits( *tag, file_name, line, column );
+
+		this->m_stack.push( tag );
+		m_positions.push_back( std::make_pair( line, column ) );
+
+		tag->on_start( parser_info_t< Trait >( this->m_source, line, column ) );
+
+		const int count = m_reader.attributes_count();
+
+		// Attributes are the values of the tag.
+		if( this->m_limits.m_max_values &&
+			static_cast< std::size_t > ( count ) > this->m_limits.m_max_values )
+				this->fail( error_code_t::limit_exceeded, file_name, line, column,
+					tag->name(), Trait::from_ascii( "values" ) );
+
+		// Indexes of the attributes by the numbers in the names.
+		m_order.assign( static_cast< std::size_t > ( count ), -1 );
+
+		for( int i = 0; i < count; ++i )
+		{
+			const int number = m_reader.attribute_number( i, count );
+
+			if( number > 0 )
+				m_order[ number - 1 ] = i;
+		}
+
+		for( const int i : m_order )
+		{
+			if( i >= 0 )
+			{
+				const typename Trait::string_t & raw = m_reader.attribute_value( i );
+				typename Trait::string_t value;
+
+				try {
+					value = unescape< Trait >( raw, 0, raw.length() );
+				}
+				catch( const exception_t< Trait > & x )
+				{
+					throw exception_t< Trait > ( x.desc() +
+						Trait::from_ascii( " In file \"" ) + file_name +
+						Trait::from_ascii( "\" on line " ) +
+						Trait::to_string( Reader::attribute_pos( line ) ) +
+						Trait::from_ascii( "." ) );
+				}
+
+				tag->on_string( parser_info_t< Trait >( this->m_source,
+						Reader::attribute_pos( line ),
+						Reader::attribute_pos( column ) ),
+					value );
+			}
+		}
+	}
+
+	//! Finish element.
+	void finish_element()
+	{
+		const std::pair< typename Trait::pos_t, typename Trait::pos_t > pos =
+			m_positions.back();
+
+		this->m_stack.top()->on_finish( parser_info_t< Trait >(
+			this->m_source, pos.first, pos.second ) );
+
+		this->m_stack.pop();
+		m_positions.pop_back();
+	}
+
+	//! Text in the element.
+	void characters( const typename Trait::string_t & file_name )
+	{
+		typename Trait::string_t value;
+
+		try {
+			value = from_cfgfile_format< Trait >( m_reader.text() );
+		}
+		catch( const exception_t< Trait > & x )
+		{
+			throw exception_t< Trait > ( x.desc() +
+				Trait::from_ascii( " In file \"" ) + file_name +
+				Trait::from_ascii( "\" on line " ) +
+				Trait::to_string( m_reader.line_number() ) +
+				Trait::from_ascii( "." ) );
+		}
+
+		this->m_stack.top()->on_string( parser_info_t< Trait >(
+				this->m_source, m_reader.line_number(),
+				m_reader.column_number() ),
+			value );
+	}
+
+	//! Find tag.
+	tag_t< Trait > * find_tag( const typename Trait::string_t & name,
+		const typename tag_t< Trait >::child_tags_list_t & list )
+	{
+		for( tag_t< Trait > * tag : list )
+		{
+			if( tag->name() == name )
+				return tag;
+		}
+
+		return nullptr;
+	}
+
+private:
+	//! Reader.
+	Reader m_reader;
+	//! Positions of the open elements.
+	std::vector< std::pair< typename Trait::pos_t,
+		typename Trait::pos_t > > m_positions;
+	//! Indexes of the attributes by the numbers, reused between elements.
+	std::vector< int > m_order;
+}; // class parser_xml_impl_t
+
 } /* namespace details */
 
 
@@ -501,14 +1647,45 @@ public:
 	{
 	}
 
+#ifndef CFGFILE_DISABLE_STL
+	//! Parser of UTF-8 input for std::wstring tags.
+	template< typename T = Trait, typename = typename std::enable_if<
+		std::is_same< T, wstring_trait_t >::value >::type >
+	parser_t( tag_t< T > & tag, input_stream_t< string_trait_t > & stream )
+		:	m_d( std::make_unique< details::parser_conffile_impl_t< T,
+				utf8_lexical_analyzer_t > > ( tag, stream ) )
+	{
+	}
+#endif
+
 #if defined( CFGFILE_QT_SUPPORT ) && defined( CFGFILE_XML_SUPPORT )
 	parser_t( tag_t< Trait > & tag, const QDomDocument & dom )
 		:	m_d( std::make_unique< details::parser_dom_impl_t< Trait > >
 				( tag, dom ) )
 	{
 	}
+
+	//! Parser of XML read with the \a reader while parsing, without DOM.
+	parser_t( tag_t< Trait > & tag, QXmlStreamReader & reader )
+		:	m_d( std::make_unique< details::parser_xml_impl_t< Trait,
+				details::qxml_reader_adapter_t< Trait > > > ( tag, reader ) )
+	{
+	}
 #endif
 
+	//! Parser of XML read with the \a reader while parsing, without Qt.
+	parser_t( tag_t< Trait > & tag, xml_reader_t< Trait > & reader )
+		:	m_d( std::make_unique< details::parser_xml_impl_t< Trait,
+				details::xml_reader_adapter_t< Trait > > > ( tag, reader ) )
+	{
+	}
+
+	//! Set limits of the parsing, by default there are no limits.
+	void set_limits( const parse_limits_t & limits )
+	{
+		m_d->set_limits( limits );
+	}
+
     /*!
         Parse input stream.
         \throw exception_t< Trait > on errors.
@@ -518,12 +1695,184 @@ public:
 		m_d->parse( file_name );
 	}
 
+	/*!
+		Parse input stream without throwing exceptions. In cfgfile format
+		the lexer, the parser and the built-in tags and formats don't use
+		exceptions at all.
+	*/
+	parse_result_t< Trait > try_parse( const typename Trait::string_t & file_name )
+	{
+		details::error_t< Trait > error;
+
+		m_d->try_parse( file_name, error );
+
+		return parse_result_t< Trait >( error );
+	}
+
+	/*!
+		Parse input stream and collect all errors. The rest of the tag
+		with error is skipped and parsing goes on.
+
+		\return Found errors, empty if there are no errors.
+	*/
+	std::vector< parse_result_t< Trait > > validate(
+		const typename Trait::string_t & file_name )
+	{
+		std::vector< parse_result_t< Trait > > errors;
+
+		m_d->validate( file_name, errors );
+
+		return errors;
+	}
+
+	/*!
+		Parse input stream with the whole text after the \a edit of
+		the text, that was parsed before into the tag. Only the
+		smallest tag enclosing the edit is parsed when possible.
+	*/
+	parse_result_t< Trait > try_reparse( const typename Trait::string_t & file_name,
+		const text_edit_t< Trait > & edit )
+	{
+		details::error_t< Trait > error;
+
+		m_d->try_reparse( file_name, edit, error );
+
+		return parse_result_t< Trait >( error );
+	}
+
 private:
     DISABLE_COPY( parser_t )
 
 	std::unique_ptr< details::parser_base_t< Trait > > m_d;
 }; // class parser_t
 
+
+//
+// parser_context_t
+//
+
+/*!
+	Reusable parser in cfgfile format.
+
+	Buffers of the input stream, stacks of the parser and the lexer
+	are allocated once and reused for each parsed stream. Call reset()
+	before each parse().
+*/
+template< typename Trait = string_trait_t >
+class parser_context_t final {
+public:
+	parser_context_t()
+	{
+	}
+
+	//! Set limits of the parsing, by default there are no limits.
+	void set_limits( const parse_limits_t & limits )
+	{
+		m_limits = limits;
+	}
+
+	//! \return Limits of the parsing.
+	const parse_limits_t & limits() const
+	{
+		return m_limits;
+	}
+
+	//! Start reading of the \a stream.
+	void reset( typename Trait::istream_t & stream,
+		const typename Trait::string_t & file_name )
+	{
+		if( m_stream )
+			m_stream->reset( file_name, stream );
+		else
+			m_stream = std::make_unique< input_stream_t< Trait > > (
+				file_name, stream );
+	}
+
+	/*!
+		Parse stream given in reset() into the \a tag.
+		\throw exception_t< Trait > on errors.
+	*/
+	void parse( tag_t< Trait > & tag )
+	{
+		if( !m_stream )
+			throw exception_t< Trait >( no_stream_message() );
+
+		prepare( tag );
+
+		m_parser->parse( m_stream->file_name() );
+	}
+
+	//! Parse stream given in reset() into the \a tag without exceptions.
+	parse_result_t< Trait > try_parse( tag_t< Trait > & tag )
+	{
+		details::error_t< Trait > error;
+
+		if( !m_stream )
+			return parse_result_t< Trait >(
+				details::error_t< Trait >( no_stream_message() ) );
+
+		prepare( tag );
+
+		m_parser->try_parse( m_stream->file_name(), error );
+
+		return parse_result_t< Trait >( error );
+	}
+
+	/*!
+		Parse stream given in reset() into the \a tag and collect
+		all errors.
+
+		\return Found errors, empty if there are no errors.
+	*/
+	std::vector< parse_result_t< Trait > > validate( tag_t< Trait > & tag )
+	{
+		std::vector< parse_result_t< Trait > > errors;
+
+		if( !m_stream )
+		{
+			errors.push_back( parse_result_t< Trait >(
+				details::error_t< Trait >( no_stream_message() ) ) );
+
+			return errors;
+		}
+
+		prepare( tag );
+
+		m_parser->validate( m_stream->file_name(), errors );
+
+		return errors;
+	}
+
+private:
+	//! \return Message of the error when stream is not set.
+	static typename Trait::string_t no_stream_message()
+	{
+		return Trait::from_ascii( "Stream for parsing is not set." );
+	}
+
+	//! Prepare parser for parsing into the \a tag.
+	void prepare( tag_t< Trait > & tag )
+	{
+		if( m_parser )
+			m_parser->reset( tag );
+		else
+			m_parser = std::make_unique<
+				details::parser_conffile_impl_t< Trait > > ( tag, *m_stream );
+
+		m_parser->set_limits( m_limits );
+	}
+
+private:
+	DISABLE_COPY( parser_context_t )
+
+	//! Input stream.
+	std::unique_ptr< input_stream_t< Trait > > m_stream;
+	//! Parser.
+	std::unique_ptr< details::parser_conffile_impl_t< Trait > > m_parser;
+	//! Limits.
+	parse_limits_t m_limits;
+}; // class parser_context_t
+
 } /* namespace cfgfile */
 
 #endif // CFGFILE__PARSER_HPP__INCLUDED
@@ -9,10 +9,68 @@
 
 // cfgfile include.
 #include "types.hpp"
+#include "exceptions.hpp"
+
+// C++ include.
+#include <memory>
+#include <cstddef>
 
 
 namespace cfgfile {
 
+//
+// source_t
+//
+
+//! Description of the parsed source, shared by all positions in it.
+template< typename Trait = string_trait_t >
+class source_t final {
+public:
+	source_t()
+		:	m_error( nullptr )
+	{
+	}
+
+	explicit source_t( const typename Trait::string_t & file_name )
+		:	m_file_name( file_name )
+		,	m_error( nullptr )
+	{
+	}
+
+	//! \return File name.
+	const typename Trait::string_t & file_name() const
+	{
+		return m_file_name;
+	}
+
+	//! Set file name.
+	void set_file_name( const typename Trait::string_t & file_name )
+	{
+		m_file_name = file_name;
+	}
+
+	//! \return Error sink, null if errors are thrown.
+	details::error_t< Trait > * error_sink() const
+	{
+		return m_error;
+	}
+
+	//! Set error sink, null means errors are thrown.
+	void set_error_sink( details::error_t< Trait > * error )
+	{
+		m_error = error;
+	}
+
+private:
+	DISABLE_COPY( source_t )
+
+	//! File name.
+	typename Trait::string_t m_file_name;
+	//! Error sink.
+	details::error_t< Trait > * m_error;
+}; // class source_t
+
+
 //
 // parser_info_t
 //
@@ -21,19 +79,44 @@ namespace cfgfile {
 template< typename Trait = string_trait_t >
 class parser_info_t {
 public:
+	//! Position in the \a source, that should outlive this info.
+	parser_info_t( const source_t< Trait > & source,
+		typename Trait::pos_t line_number,
+		typename Trait::pos_t column_number,
+		typename Trait::pos_t offset = -1 )
+		:	m_source( &source )
+		,	m_line_number( line_number )
+		,	m_column_number( column_number )
+		,	m_offset( offset )
+	{
+	}
+
+	/*!
+		Position in the file, the name is copied into the source owned
+		by this info. Parser uses the constructor with the shared source.
+	*/
 	parser_info_t( const typename Trait::string_t & file_name,
 		typename Trait::pos_t line_number,
-		typename Trait::pos_t column_number )
-		:	m_file_name( file_name )
+		typename Trait::pos_t column_number,
+		typename Trait::pos_t offset = -1 )
+		:	m_own_source( std::make_shared< source_t< Trait > > ( file_name ) )
+		,	m_source( m_own_source.get() )
 		,	m_line_number( line_number )
 		,	m_column_number( column_number )
+		,	m_offset( offset )
 	{
 	}
 
+	//! \return Source.
+	const source_t< Trait > & source() const
+	{
+		return *m_source;
+	}
+
 	//! \return File name.
 	const typename Trait::string_t & file_name() const
 	{
-		return m_file_name;
+		return m_source->file_name();
 	}
 
 	//! \return Line number.
@@ -48,15 +131,133 @@ public:
 		return m_column_number;
 	}
 
+	//! \return Offset in the input stream, -1 if unknown.
+	typename Trait::pos_t offset() const
+	{
+		return m_offset;
+	}
+
+	//! \return Is error stored in the error sink of the source?
+	bool has_error() const
+	{
+		return ( m_source->error_sink() &&
+			m_source->error_sink()->code() != error_code_t::none );
+	}
+
 private:
-	//! File name.
-	typename Trait::string_t m_file_name;
+	//! Source owned by this info.
+	std::shared_ptr< source_t< Trait > > m_own_source;
+	//! Source.
+	const source_t< Trait > * m_source;
 	//! Line number.
 	typename Trait::pos_t m_line_number;
 	//! Column number.
 	typename Trait::pos_t m_column_number;
+	//! Offset.
+	typename Trait::pos_t m_offset;
 }; // class parser_info_t
 
+
+namespace details {
+
+//
+// report_error
+//
+
+/*!
+	Report error at the \a info. Throws without error sink in the
+	source, else stores the first error in the sink.
+*/
+template< typename Trait >
+CFGFILE_COLD void report_error( const parser_info_t< Trait > & info,
+	error_code_t code,
+	const typename Trait::string_t & tag_name = typename Trait::string_t(),
+	const typename Trait::string_t & token = typename Trait::string_t() )
+{
+	details::error_t< Trait > * error = info.source().error_sink();
+
+	if( !error )
+		throw_error< Trait >( code, info.file_name(), info.line_number(),
+			info.column_number(), tag_name, token );
+
+	if( error->code() == error_code_t::none )
+		*error = details::error_t< Trait >( code, info.file_name(),
+			info.line_number(), info.column_number(), tag_name, token );
+}
+
+} /* namespace details */
+
+
+//
+// parsed_value_t
+//
+
+//! String value found by parser and its position in the file.
+template< typename Trait = string_trait_t >
+struct parsed_value_t {
+	//! Value.
+	typename Trait::string_t m_value;
+	//! Line number.
+	typename Trait::pos_t m_line_number;
+	//! Column number.
+	typename Trait::pos_t m_column_number;
+}; // struct parsed_value_t
+
+
+//
+// text_edit_t
+//
+
+/*!
+	Edit of the parsed text: \a m_length characters at the \a m_offset
+	are replaced with \a m_new_length characters.
+*/
+template< typename Trait = string_trait_t >
+struct text_edit_t {
+	//! Offset of the edit.
+	typename Trait::pos_t m_offset;
+	//! Amount of removed characters.
+	typename Trait::pos_t m_length;
+	//! Amount of inserted characters.
+	typename Trait::pos_t m_new_length;
+}; // struct text_edit_t
+
+
+//
+// parse_limits_t
+//
+
+/*!
+	Limits of the parsing of untrusted input, 0 means no limit.
+
+	Input exceeding a limit is rejected with error_code_t::limit_exceeded
+	as soon as the limit is reached. In XML names, values of attributes
+	and text are lexemes, and attributes are values of the tag.
+	QXmlStreamReader reads by itself, so there limits are checked after
+	each token.
+*/
+struct parse_limits_t {
+	parse_limits_t()
+		:	m_max_depth( 0 )
+		,	m_max_lexeme_length( 0 )
+		,	m_max_values( 0 )
+		,	m_max_elements( 0 )
+		,	m_max_size( 0 )
+	{
+	}
+
+	//! Max nesting depth of the tags.
+	std::size_t m_max_depth;
+	//! Max length of one lexeme.
+	std::size_t m_max_lexeme_length;
+	//! Max amount of the values of one tag.
+	std::size_t m_max_values;
+	//! Max amount of the elements of one tag_vector_of_tags_t.
+	std::size_t m_max_elements;
+	//! Max amount of the read characters.
+	std::size_t m_max_size;
+}; // struct parse_limits_t
+
 } /* namespace cfgfile */
 
 #endif // CFGFILE__PARSER_INFO_HPP__INCLUDED
@@ -12,14 +12,216 @@
 #include "const.hpp"
 #include "exceptions.hpp"
 
+// C++ include.
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <cwchar>
+#include <string>
+
 
 namespace cfgfile {
 
+namespace details {
+
+//
+// reserve
+//
+
+//! Reserve space in the std::basic_string.
+template< typename Char, typename Traits, typename Alloc >
+inline void reserve( std::basic_string< Char, Traits, Alloc > & str,
+	std::size_t size )
+{
+	str.reserve( size );
+}
+
+//! Other strings grow by themselves.
+template< typename String >
+inline void reserve( String &, std::size_t )
+{
+}
+
+
+//
+// append
+//
+
+//! Append \a count characters of the \a what from the \a pos.
+template< typename Char, typename Traits, typename Alloc >
+inline void append( std::basic_string< Char, Traits, Alloc > & to,
+	const std::basic_string< Char, Traits, Alloc > & what,
+	std::size_t pos, std::size_t count )
+{
+	to.append( what, pos, count );
+}
+
+//! Append \a count characters of the \a what from the \a pos.
+template< typename String >
+inline void append( String & to, const String & what,
+	std::size_t pos, std::size_t count )
+{
+	for( std::size_t i = pos, last = pos + count; i < last; ++i )
+		to.push_back( what[ i ] );
+}
+
+
+//
+// find_char
+//
+
+//! \return Position of the \a ch in [first, last) of the \a data or last.
+template< typename Char >
+inline std::size_t find_char( const Char * data, std::size_t first,
+	std::size_t last, Char ch )
+{
+	for( ; first < last; ++first )
+	{
+		if( data[ first ] == ch )
+			break;
+	}
+
+	return first;
+}
+
+inline std::size_t find_char( const char * data, std::size_t first,
+	std::size_t last, char ch )
+{
+	if( first >= last )
+		return last;
+
+	const void * found = std::memchr( data + first, ch, last - first );
+
+	return ( found ? static_cast< std::size_t > (
+		static_cast< const char* > ( found ) - data ) : last );
+}
+
+inline std::size_t find_char( const wchar_t * data, std::size_t first,
+	std::size_t last, wchar_t ch )
+{
+	if( first >= last )
+		return last;
+
+	const wchar_t * found = std::wmemchr( data + first, ch, last - first );
+
+	return ( found ? static_cast< std::size_t > ( found - data ) : last );
+}
+
+
+//
+// needs_quotes
+//
+
+/*!
+	\return Must the \a what be quoted in cfgfile format?
+
+	It's so if there is a space, a curl brace, quotes, a back-slash
+	or a start or a finish of a comment. Checked in one pass.
+*/
+template< typename Trait >
+inline bool needs_quotes( const typename Trait::string_t & what )
+{
+	const std::size_t length = static_cast< std::size_t > ( what.length() );
+
+	// Was the previous character "#", i.e. "#|" is a finish of a comment.
+	bool after_sharp = false;
+
+	for( std::size_t i = 0; i < length; ++i )
+	{
+		const typename Trait::char_t ch = what[ i ];
+
+		switch( const_t< Trait >::char_class( ch ) )
+		{
+			case char_class_t::other :
+				after_sharp = ( ch == const_t< Trait >::c_sharp );
+				break;
+
+			case char_class_t::vertical_bar :
+			{
+				if( after_sharp )
+					return true;
+
+				if( i + 1 < length &&
+					( what[ i + 1 ] == const_t< Trait >::c_vertical_bar ||
+						what[ i + 1 ] == const_t< Trait >::c_sharp ) )
+							return true;
+			}
+				break;
+
+			default :
+				return true;
+		}
+	}
+
+	return false;
+}
+
+//
+// unescape
+//
+
+/*!
+	\return Characters in [pos, last) of the \a what with replaced
+	back-slash sequences. Characters between them are copied in bulk.
+*/
+template< typename Trait >
+inline typename Trait::string_t unescape( const typename Trait::string_t & what,
+	std::size_t pos, std::size_t last )
+{
+	typename Trait::string_t result;
+
+	reserve( result, last - pos );
+
+	while( pos < last )
+	{
+		const std::size_t back_slash = find_char( what.data(), pos, last,
+			const_t< Trait >::c_back_slash );
+
+		append( result, what, pos, back_slash - pos );
+
+		if( back_slash == last )
+			break;
+
+		if( back_slash + 1 == last )
+			throw exception_t< Trait > ( Trait::from_ascii(
+				"Unfinished backslash sequence \"\\\"." ) );
+
+		const typename Trait::char_t ch = what[ back_slash + 1 ];
+
+		if( ch == const_t< Trait >::c_quotes )
+			result.push_back( const_t< Trait >::c_quotes );
+		else if( ch == const_t< Trait >::c_n )
+			result.push_back( const_t< Trait >::c_carriage_return );
+		else if( ch == const_t< Trait >::c_r )
+			result.push_back( const_t< Trait >::c_line_feed );
+		else if( ch == const_t< Trait >::c_t )
+			result.push_back( const_t< Trait >::c_tab );
+		else if( ch == const_t< Trait >::c_back_slash )
+			result.push_back( const_t< Trait >::c_back_slash );
+		else
+			throw exception_t< Trait > ( Trait::from_ascii(
+					"Unrecognized backslash sequence \"\\" ) +
+				typename Trait::string_t( 1, ch ) +
+				Trait::from_ascii( "\"." ) );
+
+		pos = back_slash + 2;
+	}
+
+	return result;
+}
+
+} /* namespace details */
+
+
 //
 // to_cfgfile_format
 //
 
-//! Format string to cfgfile format.
+/*!
+	Format string to cfgfile format.
+
+	Characters between the escaped ones are copied in bulk.
+*/
 template< typename Trait >
 static inline typename Trait::string_t to_cfgfile_format(
 	const typename Trait::string_t & what )
@@ -27,44 +229,61 @@ static inline typename Trait::string_t to_cfgfile_format(
 	if( what.empty() )
 		return Trait::from_ascii( "\"\"" );
 
-	if( what.find( const_t< Trait >::c_begin_tag ) == Trait::string_t::npos &&
-		what.find( const_t< Trait >::c_end_tag ) == Trait::string_t::npos &&
-		what.find( const_t< Trait >::c_quotes ) == Trait::string_t::npos &&
-		what.find( const_t< Trait >::c_carriage_return ) == Trait::string_t::npos &&
-		what.find( const_t< Trait >::c_line_feed ) == Trait::string_t::npos &&
-		what.find( const_t< Trait >::c_tab )  == Trait::string_t::npos &&
-		what.find( const_t< Trait >::c_back_slash ) == Trait::string_t::npos &&
-		what.find( const_t< Trait >::c_space ) == Trait::string_t::npos &&
-		what.find( const_t< Trait >::c_one_line_comment ) == Trait::string_t::npos &&
-		what.find( const_t< Trait >::c_start_multi_line_comment ) == Trait::string_t::npos &&
-		what.find( const_t< Trait >::c_finish_multi_line_comment ) == Trait::string_t::npos )
-			return what;
-	else
-	{
-		typename Trait::string_t result;
+	if( !details::needs_quotes< Trait >( what ) )
+		return what;
+
+	const std::size_t length = static_cast< std::size_t > ( what.length() );
+
+	typename Trait::string_t result;
+
+	details::reserve( result, length + 2 );
 
-		result.push_back( const_t< Trait >::c_quotes );
+	result.push_back( const_t< Trait >::c_quotes );
+
+	std::size_t pos = 0;
+
+	for( std::size_t i = 0; i < length; ++i )
+	{
+		const typename Trait::char_t ch = what[ i ];
+		typename Trait::char_t escaped = ch;
 
-		for( const typename Trait::char_t & ch : what )
+		switch( const_t< Trait >::char_class( ch ) )
 		{
-			if( ch == const_t< Trait >::c_quotes )
-				result.append( Trait::from_ascii( "\\\"" ) );
-			else if( ch == const_t< Trait >::c_carriage_return )
-				result.append( Trait::from_ascii( "\\n" ) );
-			else if( ch == const_t< Trait >::c_line_feed )
-				result.append( Trait::from_ascii( "\\r" ) );
-			else if( ch == const_t< Trait >::c_tab )
-				result.append( Trait::from_ascii( "\\t" ) );
-			else if( ch == const_t< Trait >::c_back_slash )
-				result.append( Trait::from_ascii( "\\\\" ) );
-			else
-				result.push_back( ch );
+			case details::char_class_t::quotes :
+			case details::char_class_t::back_slash :
+				break;
+
+			case details::char_class_t::new_line :
+				escaped = ( ch == const_t< Trait >::c_carriage_return ?
+					const_t< Trait >::c_n : const_t< Trait >::c_r );
+				break;
+
+			case details::char_class_t::space :
+			{
+				if( ch == const_t< Trait >::c_tab )
+					escaped = const_t< Trait >::c_t;
+				else
+					continue;
+			}
+				break;
+
+			default :
+				continue;
 		}
 
-		result.push_back( const_t< Trait >::c_quotes );
+		details::append( result, what, pos, i - pos );
 
-		return result;
+		result.push_back( const_t< Trait >::c_back_slash );
+		result.push_back( escaped );
+
+		pos = i + 1;
 	}
+
+	details::append( result, what, pos, length - pos );
+
+	result.push_back( const_t< Trait >::c_quotes );
+
+	return result;
 } // to_cfgfile_format
 
 
@@ -77,47 +296,12 @@ template< typename Trait = string_trait_t >
 static inline typename Trait::string_t from_cfgfile_format(
 	const typename Trait::string_t & what )
 {
-	if( what.find( const_t< Trait >::c_quotes ) == 0 &&
-		what.rfind( const_t< Trait >::c_quotes ) == what.length() - 1 )
-	{
-		typename Trait::string_t tmp = what.substr( 1, what.length() - 2 );
-
-		typename Trait::string_t result;
+	const std::size_t length = static_cast< std::size_t > ( what.length() );
 
-		for( typename Trait::string_t::size_type i = 0; i < tmp.length(); ++i )
-		{
-			if( tmp.at( i ) == const_t< Trait >::c_back_slash )
-			{
-				if( i + 1 < tmp.length() )
-				{
-					if( tmp.at( i + 1 ) == const_t< Trait >::c_quotes )
-						result.push_back( const_t< Trait >::c_quotes );
-					else if( tmp.at( i + 1 ) == const_t< Trait >::c_n )
-						result.push_back( const_t< Trait >::c_carriage_return );
-					else if( tmp.at( i + 1 ) == const_t< Trait >::c_r )
-						result.push_back( const_t< Trait >::c_line_feed );
-					else if( tmp.at( i + 1 ) == const_t< Trait >::c_t )
-						result.push_back( const_t< Trait >::c_tab );
-					else if( tmp.at( i + 1 ) == const_t< Trait >::c_back_slash )
-						result.push_back( const_t< Trait >::c_back_slash );
-					else
-						throw exception_t< Trait > ( Trait::from_ascii(
-								"Unrecognized backslash sequence \"\\" ) +
-							typename Trait::string_t( 1, tmp.at( i + 1 ) ) +
-							Trait::from_ascii( "\"." ) );
-
-					++i;
-				}
-				else
-					throw exception_t< Trait > ( Trait::from_ascii(
-						"Unfinished backslash sequence \"\\\"." ) );
-			}
-			else
-				result.push_back( tmp.at( i ) );
-		}
-
-		return result;
-	}
+	if( length > 0 && what[ 0 ] == const_t< Trait >::c_quotes &&
+		what[ length - 1 ] == const_t< Trait >::c_quotes )
+			return details::unescape< Trait >( what, 1,
+				( length > 1 ? length - 1 : 1 ) );
 	else
 		return what;
 } // from_cfgfile_format
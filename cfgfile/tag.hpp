@@ -11,16 +11,19 @@
 // Qt include.
 #include <QDomDocument>
 #include <QDomElement>
+#include <QXmlStreamWriter>
 #endif
 
 // cfgfile include.
 #include "parser_info.hpp"
 #include "types.hpp"
 #include "exceptions.hpp"
+#include "name_table.hpp"
 
 // C++ include.
 #include <vector>
 #include <algorithm>
+#include <cstdint>
 
 
 namespace cfgfile {
@@ -36,29 +39,43 @@ public:
     template< typename T1 > friend class parser_t;
 
     //! List with children.
-    typedef std::vector< tag_t< Trait >* > child_tags_list_t;
+    typedef std::vector< tag_t< Trait >*,
+		typename Trait::template allocator_t< tag_t< Trait >* > >
+			child_tags_list_t;
 
 	//! Construct tag.
     explicit tag_t( const typename Trait::string_t & name,
 		bool is_mandatory = false )
-		:   m_name( name )
+		:   m_name( &name_table_t< Trait >::intern( name ) )
 		,   m_is_mandatory( is_mandatory )
 		,   m_is_defined( false )
 		,	m_parent( nullptr )
 		,	m_line_number( -1 )
 		,	m_column_number( -1 )
+		,	m_offset( -1 )
+		,	m_end_line_number( -1 )
+		,	m_end_column_number( -1 )
+		,	m_end_offset( -1 )
+		,	m_content_hash( 0 )
+		,	m_is_content_hash_valid( false )
 	{
 	}
 
 	//! Construct tag.
     tag_t( tag_t< Trait > & owner, const typename Trait::string_t & name,
 		bool is_mandatory = false )
-		:   m_name( name )
+		:   m_name( &name_table_t< Trait >::intern( name ) )
 		,   m_is_mandatory( is_mandatory )
 		,   m_is_defined( false )
 		,	m_parent( nullptr )
 		,	m_line_number( -1 )
 		,	m_column_number( -1 )
+		,	m_offset( -1 )
+		,	m_end_line_number( -1 )
+		,	m_end_column_number( -1 )
+		,	m_end_offset( -1 )
+		,	m_content_hash( 0 )
+		,	m_is_content_hash_valid( false )
 	{
 		owner.add_child( *this );
 	}
@@ -73,7 +90,7 @@ public:
 		if( std::find_if( m_child_tags.cbegin(), m_child_tags.cend(),
 			[ &tag ] ( const tag_t< Trait > * t )
 			{
-				return ( tag.name() == t->name() );
+				return ( tag.has_same_name( *t ) );
 			} ) != m_child_tags.cend() )
 		{
 			throw exception_t< Trait > (
@@ -90,6 +107,8 @@ public:
 			m_child_tags.push_back( &tag );
 
 			tag.set_parent( this );
+
+			invalidate_content_hash();
 		}
 	}
 
@@ -103,6 +122,8 @@ public:
 			m_child_tags.erase( it );
 
 			tag.set_parent( nullptr );
+
+			invalidate_content_hash();
 		}
 	}
 
@@ -115,7 +136,17 @@ public:
     //! \return Name of the tag.
     const typename Trait::string_t & name() const
 	{
-		return m_name;
+		return *m_name;
+	}
+
+	/*!
+		\return Has \a other tag the same name?
+
+		Names are interned, so it's just a comparison of addresses.
+	*/
+	bool has_same_name( const tag_t< Trait > & other ) const
+	{
+		return ( m_name == other.m_name );
 	}
 
     //! \return Is this tag mandatory?
@@ -140,6 +171,48 @@ public:
     void set_defined( bool on = true )
 	{
 		m_is_defined = on;
+
+		invalidate_content_hash();
+	}
+
+	/*!
+		\return Hash of the name, "defined" state, values, children
+		and repeated tags of this tag.
+
+		Hash is computed bottom-up on the first call and cached, parsing
+		doesn't compute it. Any change of the tag or its children resets
+		the cached hash of the tag and its parents, so it's computed again
+		on the next call.
+	*/
+	std::uint64_t content_hash() const
+	{
+		if( m_is_content_hash_valid )
+			return m_content_hash;
+
+		std::uint64_t h = details::name_hash_t< Trait >::hash( name() );
+
+		if( is_defined() )
+		{
+			combine( h, 1 );
+			combine( h, details::name_hash_t< Trait >::hash( print_values() ) );
+		}
+		else
+			combine( h, 0 );
+
+		for( const tag_t< Trait > * child : children() )
+			combine( h, child->content_hash() );
+
+		const std::size_t count = elements_count();
+
+		for( std::size_t i = 0; i < count; ++i )
+			combine( h, element( i )->content_hash() );
+
+		m_content_hash = h;
+		// Parent of the repeated tags is the parent of this tag, so their
+		// changes don't reset the hash of this tag, don't cache it.
+		m_is_content_hash_valid = ( count == 0 );
+
+		return h;
 	}
 
 	//! \return Line number.
@@ -154,6 +227,74 @@ public:
 		return m_column_number;
 	}
 
+	//! \return Offset of the name of the tag in the input, -1 if unknown.
+	typename Trait::pos_t offset() const
+	{
+		return m_offset;
+	}
+
+	//! \return Line number of the finish curl brace.
+	typename Trait::pos_t end_line_number() const
+	{
+		return m_end_line_number;
+	}
+
+	//! \return Column number of the finish curl brace.
+	typename Trait::pos_t end_column_number() const
+	{
+		return m_end_column_number;
+	}
+
+	//! \return Offset of the finish curl brace in the input, -1 if unknown.
+	typename Trait::pos_t end_offset() const
+	{
+		return m_end_offset;
+	}
+
+	//! Set position of the finish curl brace. Called by the parser.
+	void set_end_position( const parser_info_t< Trait > & info )
+	{
+		m_end_line_number = info.line_number();
+		m_end_column_number = info.column_number();
+		m_end_offset = info.offset();
+	}
+
+	/*!
+		Move positions of this tag, that are at the \a offset or after,
+		when the text before them was edited. Columns are moved only
+		on the \a line_number.
+	*/
+	void shift_position( typename Trait::pos_t offset,
+		typename Trait::pos_t offset_delta,
+		typename Trait::pos_t line_number,
+		typename Trait::pos_t line_delta,
+		typename Trait::pos_t column_delta )
+	{
+		shift( m_offset, m_line_number, m_column_number,
+			offset, offset_delta, line_number, line_delta, column_delta );
+		shift( m_end_offset, m_end_line_number, m_end_column_number,
+			offset, offset_delta, line_number, line_delta, column_delta );
+	}
+
+	/*!
+		Forget parsed values of this tag and its children,
+		so the tag can be parsed again.
+	*/
+	virtual void clear()
+	{
+		m_is_defined = false;
+		invalidate_content_hash();
+		m_line_number = -1;
+		m_column_number = -1;
+		m_offset = -1;
+		m_end_line_number = -1;
+		m_end_column_number = -1;
+		m_end_offset = -1;
+
+		for( tag_t< Trait > * tag : children() )
+			tag->clear();
+	}
+
 	//! \return List with children.
 	virtual const child_tags_list_t & children() const
 	{
@@ -163,10 +304,58 @@ public:
 	//! Print tag to the output.
 	virtual typename Trait::string_t print( int indent = 0 ) const = 0;
 
+	//! \return Values of the tag in cfgfile format, without name and children.
+	virtual typename Trait::string_t print_values() const
+	{
+		return typename Trait::string_t();
+	}
+
+	//! \return Amount of repeated tags, i.e. in tag_vector_of_tags_t.
+	virtual std::size_t elements_count() const
+	{
+		return 0;
+	}
+
+	//! \return Repeated tag with the \a index.
+	virtual const tag_t< Trait > * element( std::size_t ) const
+	{
+		return nullptr;
+	}
+
+	//! \return Repeated tag with the \a index.
+	virtual tag_t< Trait > * element( std::size_t )
+	{
+		return nullptr;
+	}
+
 #if defined( CFGFILE_QT_SUPPORT ) && defined( CFGFILE_XML_SUPPORT )
 	//! Print tag to the output.
 	virtual void print( QDomDocument & doc,
 		QDomElement * parent = 0 ) const = 0;
+
+	/*!
+		Print tag to the \a writer.
+
+		Tags of cfgfile write XML directly. By default the tag is
+		printed to DOM and the DOM is written.
+
+		\note write_cfgfile() writes XML only with this method. A class
+		derived from tag_no_value_t, tag_scalar_t, tag_scalar_vector_t
+		or tag_vector_of_tags_t that overrides only
+		print( QDomDocument &, QDomElement * ) has to override this
+		method too, e.g. with tag_t::print( QXmlStreamWriter & ),
+		otherwise its DOM printing isn't used for XML.
+	*/
+	virtual void print( QXmlStreamWriter & writer ) const
+	{
+		QDomDocument doc;
+
+		print( doc );
+
+		for( QDomElement e = doc.firstChildElement(); !e.isNull();
+			e = e.nextSiblingElement() )
+				write_dom( writer, e );
+	}
 #endif
 
     //! Called when tag parsing started.
@@ -174,6 +363,7 @@ public:
 	{
 		m_line_number = info.line_number();
 		m_column_number = info.column_number();
+		m_offset = info.offset();
 	}
 
     //! Called when tag parsing finished.
@@ -183,6 +373,26 @@ public:
 	virtual void on_string( const parser_info_t< Trait > & info,
 		const typename Trait::string_t & str ) = 0;
 
+	/*!
+		Called when several strings in a row found.
+
+		\a info is the position of the first string. By default
+		on_string() is called for each string.
+	*/
+	virtual void on_strings( const parser_info_t< Trait > & info,
+		const std::vector< parsed_value_t< Trait > > & values )
+	{
+		for( const parsed_value_t< Trait > & v : values )
+		{
+			on_string( parser_info_t< Trait >( info.source(),
+					v.m_line_number, v.m_column_number ),
+				v.m_value );
+
+			if( info.has_error() )
+				return;
+		}
+	}
+
 protected:
 	template< class T1, class T2 > friend class tag_vector_of_tags_t;
 
@@ -205,11 +415,78 @@ protected:
 		return m_is_defined;
 	}
 
+private:
+#if defined( CFGFILE_QT_SUPPORT ) && defined( CFGFILE_XML_SUPPORT )
+	//! Write the \a element with attributes and children to the \a writer.
+	static void write_dom( QXmlStreamWriter & writer, const QDomElement & element )
+	{
+		writer.writeStartElement( element.tagName() );
+
+		const QDomNamedNodeMap attributes = element.attributes();
+
+		for( int i = 0; i < attributes.count(); ++i )
+		{
+			const QDomAttr attr = attributes.item( i ).toAttr();
+
+			writer.writeAttribute( attr.name(), attr.value() );
+		}
+
+		for( QDomNode n = element.firstChild(); !n.isNull();
+			n = n.nextSibling() )
+		{
+			if( n.isElement() )
+				write_dom( writer, n.toElement() );
+			else if( n.isText() )
+				writer.writeCharacters( n.toText().data() );
+		}
+
+		writer.writeEndElement();
+	}
+#endif
+
+	/*!
+		Reset cached hash of this tag and its parents.
+
+		The whole chain is walked: a tag with repeated elements doesn't
+		cache its hash, but its parents do.
+	*/
+	void invalidate_content_hash()
+	{
+		for( const tag_t< Trait > * tag = this; tag; tag = tag->m_parent )
+			tag->m_is_content_hash_valid = false;
+	}
+
+	//! Mix the \a value into the \a h.
+	static void combine( std::uint64_t & h, std::uint64_t value )
+	{
+		h ^= value + 0x9E3779B97F4A7C15ull + ( h << 6 ) + ( h >> 2 );
+	}
+
+	//! Move one position, see shift_position().
+	static void shift( typename Trait::pos_t & pos_offset,
+		typename Trait::pos_t & pos_line_number,
+		typename Trait::pos_t & pos_column_number,
+		typename Trait::pos_t offset,
+		typename Trait::pos_t offset_delta,
+		typename Trait::pos_t line_number,
+		typename Trait::pos_t line_delta,
+		typename Trait::pos_t column_delta )
+	{
+		if( pos_offset < offset )
+			return;
+
+		if( pos_line_number == line_number )
+			pos_column_number += column_delta;
+
+		pos_line_number += line_delta;
+		pos_offset += offset_delta;
+	}
+
 private:
     DISABLE_COPY( tag_t )
 
-	//! Name.
-	typename Trait::string_t m_name;
+	//! Name, interned in name_table_t.
+	const typename Trait::string_t * m_name;
 	//! Is tag mandatory?
     bool m_is_mandatory;
 	//! Is tag defined?
@@ -222,6 +499,18 @@ private:
 	typename Trait::pos_t m_line_number;
 	//! Column number.
 	typename Trait::pos_t m_column_number;
+	//! Offset of the name of the tag.
+	typename Trait::pos_t m_offset;
+	//! Line number of the finish curl brace.
+	typename Trait::pos_t m_end_line_number;
+	//! Column number of the finish curl brace.
+	typename Trait::pos_t m_end_column_number;
+	//! Offset of the finish curl brace.
+	typename Trait::pos_t m_end_offset;
+	//! Cached hash of the contents.
+	mutable std::uint64_t m_content_hash;
+	//! Is m_content_hash up to date?
+	mutable bool m_is_content_hash_valid;
 }; // class tag_t
 
 } /* namespace cfgfile */
@@ -17,6 +17,7 @@
 // Qt include.
 #include <QDomDocument>
 #include <QDomElement>
+#include <QXmlStreamWriter>
 #endif
 
 
@@ -101,6 +102,20 @@ public:
 			}
 		}
 	}
+
+	//! Print tag to the \a writer.
+	void print( QXmlStreamWriter & writer ) const override
+	{
+		if( this->is_defined() )
+		{
+			writer.writeStartElement( QString( this->name() ) );
+
+			for( const tag_t< Trait > * tag : this->children() )
+				tag->print( writer );
+
+			writer.writeEndElement();
+		}
+	}
 #endif
 
 	//! Called when tag parsing finished.
@@ -109,15 +124,13 @@ public:
 		for( const tag_t< Trait > * tag : this->children() )
 		{
 			if( tag->is_mandatory() && !tag->is_defined() )
-				throw exception_t< Trait >(
-					Trait::from_ascii( "Undefined child mandatory tag: \"" ) +
-					tag->name() +
-					Trait::from_ascii( "\". Where parent is: \"" ) +
-					this->name() +
-					Trait::from_ascii( "\". In file \"" ) + info.file_name() +
-					Trait::from_ascii( "\" on line " ) +
-					Trait::to_string( info.line_number() ) +
-					Trait::from_ascii( "." ) );
+			{
+				details::report_error( info,
+					error_code_t::undefined_child_mandatory_tag, this->name(),
+					tag->name() );
+
+				return;
+			}
 		}
 
 		this->set_defined();
@@ -127,13 +140,8 @@ public:
 	void on_string( const parser_info_t< Trait > & info,
 		const typename Trait::string_t & str ) override
 	{
-		throw exception_t< Trait >( Trait::from_ascii( "Tag \"" ) +
-			this->name() + Trait::from_ascii( "\" doesn't allow any values. "
-				"But we've got this: \"" ) +
-			str + Trait::from_ascii( "\". In file \"" ) + info.file_name() +
-			Trait::from_ascii( "\" on line " ) +
-			Trait::to_string( info.line_number() ) +
-			Trait::from_ascii( "." ) );
+		details::report_error( info, error_code_t::value_is_not_allowed,
+			this->name(), str );
 	}
 }; // class tag_no_value_t
 
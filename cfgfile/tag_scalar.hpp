@@ -20,6 +20,7 @@
 #include <QDomDocument>
 #include <QDomElement>
 #include <QDomText>
+#include <QXmlStreamWriter>
 #endif
 
 
@@ -40,7 +41,6 @@ public:
 		bool is_mandatory = false )
 		:	tag_t< Trait >( name, is_mandatory )
 		,	m_value( T() )
-		,	m_constraint( nullptr )
 	{
 	}
 
@@ -49,7 +49,6 @@ public:
 		bool is_mandatory = false )
 		:	tag_t< Trait >( owner, name, is_mandatory )
 		,	m_value( T() )
-		,	m_constraint( nullptr )
 	{
 	}
 
@@ -70,7 +69,7 @@ public:
 	{
 		if( m_constraint )
 		{
-			if( !m_constraint->check( v ) )
+			if( !m_constraint.check( v ) )
 				throw exception_t< Trait >(
 					Trait::from_ascii( "Invalid value: \"" ) +
 					typename Trait::string_t(
@@ -103,7 +102,28 @@ public:
 	void
 	set_constraint( constraint_t< T > * c )
 	{
-		m_constraint = c;
+		m_constraint.set( c );
+	}
+
+	//! Set check function for the tag's value.
+	void
+	set_constraint( typename constraint_checker_t< T >::check_func_t f )
+	{
+		m_constraint.set( f );
+	}
+
+	//! Remove constraint.
+	void
+	set_constraint( std::nullptr_t )
+	{
+		m_constraint.set( static_cast< constraint_t< T >* > ( nullptr ) );
+	}
+
+	//! \return Value of the tag in cfgfile format.
+	typename Trait::string_t print_values() const override
+	{
+		return to_cfgfile_format< Trait >(
+			format_t< T, Trait >::to_string( m_value ) );
 	}
 
 	//! Print tag to the output.
@@ -171,31 +191,56 @@ public:
 			}
 		}
 	}
+
+	//! Print tag to the \a writer.
+	void print( QXmlStreamWriter & writer ) const override
+	{
+		if( this->is_defined() )
+		{
+			writer.writeStartElement( QString( this->name() ) );
+
+			const QString value = to_cfgfile_format< Trait >(
+				format_t< T, Trait >::to_string( m_value ) );
+
+			writer.writeCharacters( value );
+
+			for( const tag_t< Trait > * tag : this->children() )
+				tag->print( writer );
+
+			writer.writeEndElement();
+		}
+	}
 #endif
 
+	//! Forget parsed value.
+	void clear() override
+	{
+		m_value = T();
+
+		tag_t< Trait >::clear();
+	}
+
 	//! Called when tag parsing finished.
 	void on_finish( const parser_info_t< Trait > & info ) override
 	{
 		if( !this->is_defined_member_value() )
-			throw exception_t< Trait >(
-				Trait::from_ascii( "Undefined value of tag: \"" ) +
-				this->name() + Trait::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				Trait::from_ascii( "\" on line " ) +
-				Trait::to_string( info.line_number() ) +
-				Trait::from_ascii( "." ) );
+		{
+			details::report_error( info, error_code_t::undefined_value,
+				this->name() );
+
+			return;
+		}
 
 		for( const tag_t< Trait > * tag : this->children() )
 		{
 			if( tag->is_mandatory() && !tag->is_defined() )
-				throw exception_t< Trait >(
-					Trait::from_ascii( "Undefined child mandatory tag: \"" ) +
-					tag->name() + Trait::from_ascii( "\". Where parent is: \"" ) +
-					this->name() + Trait::from_ascii( "\". In file \"" ) +
-					info.file_name() +
-					Trait::from_ascii( "\" on line " ) +
-					Trait::to_string( info.line_number() ) +
-					Trait::from_ascii( "." ) );
+			{
+				details::report_error( info,
+					error_code_t::undefined_child_mandatory_tag, this->name(),
+					tag->name() );
+
+				return;
+			}
 		}
 	}
 
@@ -206,30 +251,28 @@ public:
 		if( !this->is_defined_member_value() )
 		{
 			if( this->is_any_child_defined() )
-				throw exception_t< Trait >(
-					Trait::from_ascii( "Value \"" ) + str +
-					Trait::from_ascii( "\" for tag \"" ) + this->name() +
-					Trait::from_ascii( "\" must be defined before any "
-						"child tag. In file \"" ) +
-					info.file_name() + Trait::from_ascii( "\" on line " ) +
-					Trait::to_string( info.line_number() ) +
-					Trait::from_ascii( "." ) );
+			{
+				details::report_error( info,
+					error_code_t::value_after_child_tag, this->name(), str );
+
+				return;
+			}
 
 			T value = format_t< T, Trait >::from_string( info, str );
 
+			if( info.has_error() )
+				return;
+
 			if( m_constraint )
 			{
-				if( !m_constraint->check( value ) )
-					throw exception_t< Trait >(
-						Trait::from_ascii( "Invalid value: \"" ) +
-						str +
-						Trait::from_ascii( "\". Value must match to the "
-							"constraint in tag \"" ) +
-						this->name() + Trait::from_ascii( "\". In file \"" ) +
-						info.file_name() +
-						Trait::from_ascii( "\" on line " ) +
-						Trait::to_string( info.line_number() ) +
-						Trait::from_ascii( "." ) );
+				if( !m_constraint.check( value ) )
+				{
+					details::report_error( info,
+						error_code_t::value_does_not_match_constraint,
+						this->name(), str );
+
+					return;
+				}
 			}
 
 			m_value = value;
@@ -237,20 +280,15 @@ public:
 			this->set_defined();
 		}
 		else
-			throw exception_t< Trait >(
-				Trait::from_ascii( "Value for the tag \"" ) +
-				this->name() +
-				Trait::from_ascii( "\" already defined. In file \"" ) +
-				info.file_name() + Trait::from_ascii( "\" on line " ) +
-				Trait::to_string( info.line_number() ) +
-				Trait::from_ascii( "." ) );
+			details::report_error( info, error_code_t::value_already_defined,
+				this->name() );
 	}
 
 private:
 	//! Value of the tag.
 	T m_value;
 	//! Constraint.
-	constraint_t< T > * m_constraint;
+	constraint_checker_t< T > m_constraint;
 }; // class tag_scalar_t
 
 
@@ -314,6 +352,13 @@ public:
 			receiver = m_value;
 	}
 
+	//! \return Value of the tag in cfgfile format.
+	typename Trait::string_t print_values() const override
+	{
+		return to_cfgfile_format< Trait >(
+			format_t< bool, Trait >::to_string( m_value ) );
+	}
+
 	//! Print tag to the output.
 	typename Trait::string_t print( int indent = 0 ) const override
 	{
@@ -380,32 +425,56 @@ public:
 			}
 		}
 	}
+
+	//! Print tag to the \a writer.
+	void print( QXmlStreamWriter & writer ) const override
+	{
+		if( this->is_defined() )
+		{
+			writer.writeStartElement( QString( this->name() ) );
+
+			const QString value = to_cfgfile_format< Trait >(
+				format_t< bool, Trait >::to_string( m_value ) );
+
+			writer.writeCharacters( value );
+
+			for( const tag_t< Trait > * tag : this->children() )
+				tag->print( writer );
+
+			writer.writeEndElement();
+		}
+	}
 #endif
 
+	//! Forget parsed value.
+	void clear() override
+	{
+		m_value = false;
+
+		tag_t< Trait >::clear();
+	}
+
 	//! Called when tag parsing finished.
 	void on_finish( const parser_info_t< Trait > & info ) override
 	{
 		if( !this->is_defined_member_value() )
-			throw exception_t< Trait >(
-				Trait::from_ascii( "Undefined value of tag: \"" ) +
-				this->name() + Trait::from_ascii( "\". In file \"" ) +
-				info.file_name() +
-				Trait::from_ascii( "\" on line " ) +
-				Trait::to_string( info.line_number() ) +
-				Trait::from_ascii( "." ) );
+		{
+			details::report_error( info, error_code_t::undefined_value,
+				this->name() );
+
+			return;
+		}
 
 		for( const tag_t< Trait > * tag : this->children() )
 		{
 			if( tag->is_mandatory() && !tag->is_defined() )
-				throw exception_t< Trait >(
-					Trait::from_ascii( "Undefined child mandatory tag: \"" ) +
-					tag->name() +
-					Trait::from_ascii( "\". Where parent is: \"" ) +
-					this->name() + Trait::from_ascii( "\". In file \"" ) +
-					info.file_name() +
-					Trait::from_ascii( "\" on line " ) +
-					Trait::to_string( info.line_number() ) +
-					Trait::from_ascii( "." ) );
+			{
+				details::report_error( info,
+					error_code_t::undefined_child_mandatory_tag, this->name(),
+					tag->name() );
+
+				return;
+			}
 		}
 	}
 
@@ -416,27 +485,25 @@ public:
 		if( !this->is_defined_member_value() )
 		{
 			if( this->is_any_child_defined() )
-				throw exception_t< Trait >(
-					Trait::from_ascii( "Value \"" ) + str +
-					Trait::from_ascii( "\" for tag \"" ) + this->name() +
-					Trait::from_ascii( "\" must be defined before any child "
-						"tag. In file \"" ) +
-					info.file_name() + Trait::from_ascii( "\" on line " ) +
-					Trait::to_string( info.line_number() ) +
-					Trait::from_ascii( "." ) );
+			{
+				details::report_error( info,
+					error_code_t::value_after_child_tag, this->name(), str );
+
+				return;
+			}
 
-			m_value = format_t< bool, Trait >::from_string( info, str );
+			const bool value = format_t< bool, Trait >::from_string( info, str );
+
+			if( info.has_error() )
+				return;
+
+			m_value = value;
 
 			this->set_defined();
 		}
 		else
-			throw exception_t< Trait >(
-				Trait::from_ascii( "Value for the tag \"" ) +
-				this->name() +
-				Trait::from_ascii( "\" already defined. In file \"" ) +
-				info.file_name() + Trait::from_ascii( "\" on line " ) +
-				Trait::to_string( info.line_number() ) +
-				Trait::from_ascii( "." ) );
+			details::report_error( info, error_code_t::value_already_defined,
+				this->name() );
 	}
 
 private:
@@ -462,7 +529,6 @@ public:
 		bool is_mandatory = false )
 		:	tag_t< Trait >( name, is_mandatory )
 		,	m_value( typename Trait::string_t() )
-		,	m_constraint( nullptr )
 	{
 	}
 
@@ -471,7 +537,6 @@ public:
 		bool is_mandatory = false )
 		:	tag_t< Trait >( owner, name, is_mandatory )
 		,	m_value( typename Trait::string_t() )
-		,	m_constraint( nullptr )
 	{
 	}
 
@@ -492,7 +557,7 @@ public:
 	{
 		if( m_constraint )
 		{
-			if( !m_constraint->check( v ) )
+			if( !m_constraint.check( v ) )
 				throw exception_t< Trait >(
 					Trait::from_ascii( "Invalid value: \"" ) +
 					format_t< typename Trait::string_t, Trait >::to_string( v ) +
@@ -524,7 +589,28 @@ public:
 	void
 	set_constraint( constraint_t< typename Trait::string_t > * c )
 	{
-		m_constraint = c;
+		m_constraint.set( c );
+	}
+
+	//! Set check function for the tag's value.
+	void
+	set_constraint( typename constraint_checker_t< typename Trait::string_t >::check_func_t f )
+	{
+		m_constraint.set( f );
+	}
+
+	//! Remove constraint.
+	void
+	set_constraint( std::nullptr_t )
+	{
+		m_constraint.set( static_cast< constraint_t< typename Trait::string_t >* > ( nullptr ) );
+	}
+
+	//! \return Value of the tag in cfgfile format.
+	typename Trait::string_t print_values() const override
+	{
+		return to_cfgfile_format< Trait >(
+			format_t< typename Trait::string_t, Trait >::to_string( m_value ) );
 	}
 
 	//! Print tag to the output.
@@ -626,44 +712,68 @@ public:
 			}
 		}
 	}
+
+	//! Print tag to the \a writer.
+	void print( QXmlStreamWriter & writer ) const override
+	{
+		if( this->is_defined() )
+		{
+			writer.writeStartElement( QString( this->name() ) );
+
+			const QString value = to_cfgfile_format< Trait >(
+				format_t< typename Trait::string_t, Trait >::to_string( m_value ) );
+
+			writer.writeCharacters( value );
+
+			for( const tag_t< Trait > * tag : this->children() )
+				tag->print( writer );
+
+			writer.writeEndElement();
+		}
+	}
 #endif
 
+	//! Forget parsed value.
+	void clear() override
+	{
+		m_value = typename Trait::string_t();
+
+		tag_t< Trait >::clear();
+	}
+
 	//! Called when tag parsing finished.
 	void on_finish( const parser_info_t< Trait > & info ) override
 	{
 		if( !this->is_defined_member_value() )
-			throw exception_t< Trait >(
-				Trait::from_ascii( "Undefined value of tag: \"" ) +
-				this->name() + Trait::from_ascii( "\". In file \"" ) +
-				info.file_name() + Trait::from_ascii( "\" on line " ) +
-				Trait::to_string( info.line_number() ) +
-				Trait::from_ascii( "." ) );
+		{
+			details::report_error( info, error_code_t::undefined_value,
+				this->name() );
+
+			return;
+		}
 
 		if( m_constraint )
 		{
-			if( !m_constraint->check( m_value ) )
-				throw exception_t< Trait >(
-					Trait::from_ascii( "Invalid value: \"" ) +
-					m_value +
-					Trait::from_ascii( "\". Value must match to the "
-						"constraint in tag \"" ) +
-					this->name() + Trait::from_ascii( "\". In file \"" ) +
-					info.file_name() + Trait::from_ascii( "\" on line " ) +
-					Trait::to_string( info.line_number() ) +
-					Trait::from_ascii( "." ) );
+			if( !m_constraint.check( m_value ) )
+			{
+				details::report_error( info,
+					error_code_t::value_does_not_match_constraint, this->name(),
+					m_value );
+
+				return;
+			}
 		}
 
 		for( const tag_t< Trait > * tag : this->children() )
 		{
 			if( tag->is_mandatory() && !tag->is_defined() )
-				throw exception_t< Trait >(
-					Trait::from_ascii( "Undefined child mandatory tag: \"" ) +
-					tag->name() +
-					Trait::from_ascii( "\". Where parent is: \"" ) +
-					this->name() + Trait::from_ascii( "\". In file \"" ) +
-					info.file_name() + Trait::from_ascii( "\" on line " ) +
-					Trait::to_string( info.line_number() ) +
-					Trait::from_ascii( "." ) );
+			{
+				details::report_error( info,
+					error_code_t::undefined_child_mandatory_tag, this->name(),
+					tag->name() );
+
+				return;
+			}
 		}
 	}
 
@@ -672,18 +782,19 @@ public:
 		const typename Trait::string_t & str ) override
 	{
 		if( this->is_any_child_defined() )
-			throw exception_t< Trait >(
-				Trait::from_ascii( "Value \"" ) + str +
-				Trait::from_ascii( "\" for tag \"" ) + this->name() +
-				Trait::from_ascii( "\" must be defined before any child "
-					"tag. In file \"" ) +
-				info.file_name() + Trait::from_ascii( "\" on line " ) +
-				Trait::to_string( info.line_number() ) +
-				Trait::from_ascii( "." ) );
+		{
+			details::report_error( info, error_code_t::value_after_child_tag,
+				this->name(), str );
+
+			return;
+		}
 
 		const typename Trait::string_t value =
 			format_t< typename Trait::string_t, Trait >::from_string( info, str );
 
+		if( info.has_error() )
+			return;
+
 		m_value.append( value );
 
 		this->set_defined();
@@ -693,7 +804,7 @@ private:
 	//! Value of the tag.
 	typename Trait::string_t m_value;
 	//! Constraint.
-	constraint_t< typename Trait::string_t > * m_constraint;
+	constraint_checker_t< typename Trait::string_t > m_constraint;
 }; // class tag_scalar_t
 
 
@@ -716,7 +827,6 @@ public:
 		bool is_mandatory = false )
 		:	tag_t< Trait >( name, is_mandatory )
 		,	m_value( QString() )
-		,	m_constraint( nullptr )
 	{
 	}
 
@@ -725,7 +835,6 @@ public:
 		bool is_mandatory = false )
 		:	tag_t< Trait >( owner, name, is_mandatory )
 		,	m_value( QString() )
-		,	m_constraint( nullptr )
 	{
 	}
 
@@ -746,7 +855,7 @@ public:
 	{
 		if( m_constraint )
 		{
-			if( !m_constraint->check( v ) )
+			if( !m_constraint.check( v ) )
 				throw exception_t< Trait >(
 					Trait::from_ascii( "Invalid value: \"" ) +
 					typename Trait::string_t(
@@ -779,7 +888,28 @@ public:
 	void
 	set_constraint( constraint_t< QString > * c )
 	{
-		m_constraint = c;
+		m_constraint.set( c );
+	}
+
+	//! Set check function for the tag's value.
+	void
+	set_constraint( typename constraint_checker_t< QString >::check_func_t f )
+	{
+		m_constraint.set( f );
+	}
+
+	//! Remove constraint.
+	void
+	set_constraint( std::nullptr_t )
+	{
+		m_constraint.set( static_cast< constraint_t< QString >* > ( nullptr ) );
+	}
+
+	//! \return Value of the tag in cfgfile format.
+	typename Trait::string_t print_values() const override
+	{
+		return to_cfgfile_format< Trait >(
+			format_t< QString, Trait >::to_string( m_value ) );
 	}
 
 	//! Print tag to the output.
@@ -879,43 +1009,68 @@ public:
 			}
 		}
 	}
+
+	//! Print tag to the \a writer.
+	void print( QXmlStreamWriter & writer ) const override
+	{
+		if( this->is_defined() )
+		{
+			writer.writeStartElement( QString( this->name() ) );
+
+			const QString value = to_cfgfile_format< Trait >(
+				format_t< typename Trait::string_t, Trait >::to_string( m_value ) );
+
+			writer.writeCharacters( value );
+
+			for( const tag_t< Trait > * tag : this->children() )
+				tag->print( writer );
+
+			writer.writeEndElement();
+		}
+	}
 #endif // CFGFILE_XML_SUPPORT
 
+	//! Forget parsed value.
+	void clear() override
+	{
+		m_value = QString();
+
+		tag_t< Trait >::clear();
+	}
+
 	//! Called when tag parsing finished.
 	void on_finish( const parser_info_t< Trait > & info ) override
 	{
 		if( m_constraint )
 		{
-			if( !m_constraint->check( m_value ) )
-				throw exception_t< Trait >(
-					Trait::from_ascii( "Invalid value: \"" ) +
-					typename Trait::string_t( m_value ) +
-					Trait::from_ascii( "\". Value must match to the "
-						"constraint in tag \"" ) +
-					this->name() + Trait::from_ascii( "\". In file \"" ) +
-					info.file_name() + Trait::from_ascii( "\" on line " ) +
-					Trait::to_string( info.line_number() ) +
-					Trait::from_ascii( "." ) );
+			if( !m_constraint.check( m_value ) )
+			{
+				details::report_error( info,
+					error_code_t::value_does_not_match_constraint, this->name(),
+					typename Trait::string_t( m_value ) );
+
+				return;
+			}
 		}
 
 		if( !this->is_defined_member_value() )
-			throw exception_t< Trait >(
-				Trait::from_ascii( "Undefined value of tag: \"" ) +
-				this->name() + Trait::from_ascii( "\". In file \"" ) +
-				info.file_name() + Trait::from_ascii( "\" on line " ) +
-				Trait::to_string( info.line_number() ) +
-				Trait::from_ascii( "." ) );
+		{
+			details::report_error( info, error_code_t::undefined_value,
+				this->name() );
+
+			return;
+		}
 
 		for( const tag_t< Trait > * tag : this->children() )
 		{
 			if( tag->is_mandatory() && !tag->is_defined() )
-				throw exception_t< Trait >(
-					Trait::from_ascii( "Undefined child mandatory tag: \"" ) +
-					tag->name() + Trait::from_ascii( "\". Where parent is: \"" ) +
-					this->name() + Trait::from_ascii( "\". In file \"" ) +
-					info.file_name() + Trait::from_ascii( "\" on line " ) +
-					Trait::to_string( info.line_number() ) +
-					Trait::from_ascii( "." ) );
+			{
+				details::report_error( info,
+					error_code_t::undefined_child_mandatory_tag, this->name(),
+					tag->name() );
+
+				return;
+			}
 		}
 	}
 
@@ -924,17 +1079,18 @@ public:
 		const typename Trait::string_t & str ) override
 	{
 		if( this->is_any_child_defined() )
-			throw exception_t< Trait >(
-				Trait::from_ascii( "Value \"" ) + str +
-				Trait::from_ascii( "\" for tag \"" ) + this->name() +
-				Trait::from_ascii( "\" must be defined before any "
-					"child tag. In file \"" ) +
-				info.file_name() + Trait::from_ascii( "\" on line " ) +
-				Trait::to_string( info.line_number() ) +
-				Trait::from_ascii( "." ) );
+		{
+			details::report_error( info, error_code_t::value_after_child_tag,
+				this->name(), str );
+
+			return;
+		}
 
 		const QString value = format_t< QString, Trait >::from_string( info, str );
 
+		if( info.has_error() )
+			return;
+
 		m_value.append( value );
 
 		this->set_defined();
@@ -944,7 +1100,7 @@ private:
 	//! Value of the tag.
 	QString m_value;
 	//! Constraint.
-	constraint_t< QString > * m_constraint;
+	constraint_checker_t< QString > m_constraint;
 }; // class tag_scalar_t< QString >
 
 #endif // CFGFILE_QT_SUPPORT
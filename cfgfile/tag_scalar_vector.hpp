@@ -21,6 +21,7 @@
 #include <QDomDocument>
 #include <QDomElement>
 #include <QDomText>
+#include <QXmlStreamWriter>
 #endif
 
 // C++ include.
@@ -40,13 +41,13 @@ class tag_scalar_vector_t
 {
 public:
 	//! Vector of values.
-	typedef std::vector< T > values_vector_t;
+	typedef std::vector< T, typename Trait::template allocator_t< T > >
+		values_vector_t;
 
 	//! Construct tag.
 	explicit tag_scalar_vector_t( const typename Trait::string_t & name,
 		bool is_mandatory = false )
 		:	tag_t< Trait >( name, is_mandatory )
-		,	m_constraint( nullptr )
 	{
 	}
 
@@ -55,7 +56,6 @@ public:
 		const typename Trait::string_t & name,
 		bool is_mandatory = false )
 		:	tag_t< Trait >( owner, name, is_mandatory )
-		,	m_constraint( nullptr )
 	{
 	}
 
@@ -94,7 +94,7 @@ public:
 	{
 		if( m_constraint )
 		{
-			if( !m_constraint->check( v ) )
+			if( !m_constraint.check( v ) )
 				throw exception_t< Trait >(
 					Trait::from_ascii( "Invalid value: \"" ) +
 					typename Trait::string_t(
@@ -136,7 +136,38 @@ public:
 	void
 	set_constraint( constraint_t< T > * c )
 	{
-		m_constraint = c;
+		m_constraint.set( c );
+	}
+
+	//! Set check function for the tag's value.
+	void
+	set_constraint( typename constraint_checker_t< T >::check_func_t f )
+	{
+		m_constraint.set( f );
+	}
+
+	//! Remove constraint.
+	void
+	set_constraint( std::nullptr_t )
+	{
+		m_constraint.set( static_cast< constraint_t< T >* > ( nullptr ) );
+	}
+
+	//! \return Values of the tag in cfgfile format.
+	typename Trait::string_t print_values() const override
+	{
+		typename Trait::string_t result;
+
+		for( const T & v : m_values )
+		{
+			if( !result.empty() )
+				result.push_back( const_t< Trait >::c_space );
+
+			result.append( to_cfgfile_format< Trait >(
+				format_t< T, Trait >::to_string( v ) ) );
+		}
+
+		return result;
 	}
 
 	//! Print tag to the output.
@@ -222,22 +253,60 @@ public:
 			}
 		}
 	}
+
+	//! Print tag to the \a writer.
+	void print( QXmlStreamWriter & writer ) const override
+	{
+		if( this->is_defined() )
+		{
+			writer.writeStartElement( QString( this->name() ) );
+
+			typename values_vector_t::size_type i = 1;
+
+			for( const T & v : m_values )
+			{
+				QString value = to_cfgfile_format< Trait >(
+					format_t< T, Trait >::to_string( v ) );
+
+				if( value.startsWith( const_t< Trait >::c_quotes ) &&
+					value.endsWith( const_t< Trait >::c_quotes ) )
+						value = value.mid( 1, value.length() - 2 );
+
+				writer.writeAttribute( QString( "a" ) + QString::number( i ),
+					value );
+
+				++i;
+			}
+
+			for( const tag_t< Trait > * tag : this->children() )
+				tag->print( writer );
+
+			writer.writeEndElement();
+		}
+	}
 #endif
 
+	//! Forget parsed values.
+	void clear() override
+	{
+		m_values.clear();
+
+		tag_t< Trait >::clear();
+	}
+
 	//! Called when tag parsing finished.
 	void on_finish( const parser_info_t< Trait > & info ) override
 	{
 		for( const tag_t< Trait > * tag : this->children() )
 		{
 			if( tag->is_mandatory() && !tag->is_defined() )
-				throw exception_t< Trait >(
-					Trait::from_ascii( "Undefined child mandatory tag: \"" ) +
-					tag->name() +
-					Trait::from_ascii( "\". Where parent is: \"" ) +
-					this->name() + Trait::from_ascii( "\". In file \"" ) +
-					info.file_name() + Trait::from_ascii( "\" on line " ) +
-					Trait::to_string( info.line_number() ) +
-					Trait::from_ascii( "." ) );
+			{
+				details::report_error( info,
+					error_code_t::undefined_child_mandatory_tag, this->name(),
+					tag->name() );
+
+				return;
+			}
 		}
 	}
 
@@ -246,28 +315,28 @@ public:
 		const typename Trait::string_t & str ) override
 	{
 		if( this->is_any_child_defined() )
-			throw exception_t< Trait >(
-				Trait::from_ascii( "Value \"" ) + str +
-				Trait::from_ascii( "\" for tag \"" ) + this->name() +
-				Trait::from_ascii( "\" must be defined before any child "
-					"tag. In file \"" ) +
-				info.file_name() + Trait::from_ascii( "\" on line " ) +
-				Trait::to_string( info.line_number() ) +
-				Trait::from_ascii( "." ) );
+		{
+			details::report_error( info, error_code_t::value_after_child_tag,
+				this->name(), str );
+
+			return;
+		}
 
 		const T value = format_t< T, Trait >::from_string( info, str );
 
+		if( info.has_error() )
+			return;
+
 		if( m_constraint )
 		{
-			if( !m_constraint->check( value ) )
-				throw exception_t< Trait >(
-					Trait::from_ascii( "Invalid value: \"" ) +
-					str + Trait::from_ascii( "\". Value must match to the "
-						"constraint in tag \"" ) +
-					this->name() + Trait::from_ascii( "\". In file \"" ) +
-					info.file_name() + Trait::from_ascii( "\" on line " ) +
-					Trait::to_string( info.line_number() ) +
-					Trait::from_ascii( "." ) );
+			if( !m_constraint.check( value ) )
+			{
+				details::report_error( info,
+					error_code_t::value_does_not_match_constraint, this->name(),
+					str );
+
+				return;
+			}
 		}
 
 		m_values.push_back( value );
@@ -275,11 +344,62 @@ public:
 		this->set_defined();
 	}
 
+	/*!
+		Called when several strings in a row found.
+
+		Children are checked once for the whole run and storage
+		is reserved before converting values.
+	*/
+	void on_strings( const parser_info_t< Trait > & info,
+		const std::vector< parsed_value_t< Trait > > & values ) override
+	{
+		if( values.empty() )
+			return;
+
+		// Reports the same error as for the single string.
+		if( this->is_any_child_defined() )
+		{
+			on_string( info, values.front().m_value );
+
+			return;
+		}
+
+		m_values.reserve( m_values.size() + values.size() );
+
+		for( const parsed_value_t< Trait > & v : values )
+		{
+			const parser_info_t< Trait > value_info( info.source(),
+				v.m_line_number, v.m_column_number );
+
+			const T value = format_t< T, Trait >::from_string( value_info,
+				v.m_value );
+
+			if( value_info.has_error() )
+				return;
+
+			if( m_constraint )
+			{
+				if( !m_constraint.check( value ) )
+				{
+					details::report_error( value_info,
+						error_code_t::value_does_not_match_constraint,
+						this->name(), v.m_value );
+
+					return;
+				}
+			}
+
+			m_values.push_back( value );
+		}
+
+		this->set_defined();
+	}
+
 private:
 	//! Value of the tag.
 	values_vector_t m_values;
 	//! Constraint.
-	constraint_t< T > * m_constraint;
+	constraint_checker_t< T > m_constraint;
 }; // class tag_scalar_vector_t
 
 } /* namespace cfgfile */
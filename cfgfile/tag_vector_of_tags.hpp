@@ -40,7 +40,8 @@ public:
 	//! Type of the pointer to the subordinate tag,
 	typedef std::shared_ptr< T > ptr_to_tag_t;
 	//! Type of the vector of subordinate tags.
-	typedef std::vector< ptr_to_tag_t > vector_of_tags_t;
+	typedef std::vector< ptr_to_tag_t,
+		typename Trait::template allocator_t< ptr_to_tag_t > > vector_of_tags_t;
 
 	//! Construct tag.
 	explicit tag_vector_of_tags_t( const typename Trait::string_t & name,
@@ -90,6 +91,8 @@ public:
 	void
 	set_value( ptr_to_tag_t p )
 	{
+		p->set_parent( this->parent() );
+
 		m_tags.push_back( p );
 
 		this->set_defined();
@@ -101,6 +104,9 @@ public:
 	{
 		m_tags = v;
 
+		for( const ptr_to_tag_t & p : m_tags )
+			p->set_parent( this->parent() );
+
 		this->set_defined();
 	}
 
@@ -129,6 +135,24 @@ public:
 			return empty;
 	}
 
+	//! \return Amount of subordinate tags.
+	std::size_t elements_count() const override
+	{
+		return m_tags.size();
+	}
+
+	//! \return Subordinate tag with the \a index.
+	const tag_t< Trait > * element( std::size_t index ) const override
+	{
+		return m_tags.at( index ).get();
+	}
+
+	//! \return Subordinate tag with the \a index.
+	tag_t< Trait > * element( std::size_t index ) override
+	{
+		return m_tags.at( index ).get();
+	}
+
 	//! Print tag to the output.
 	typename Trait::string_t print( int indent = 0 ) const override
 	{
@@ -153,12 +177,34 @@ public:
 				p->print( doc, parent );
 		}
 	}
+
+	//! Print tag to the \a writer.
+	void print( QXmlStreamWriter & writer ) const override
+	{
+		if( this->is_defined() )
+		{
+			// Through the base, T may hide this overload of print().
+			for( const ptr_to_tag_t & p : m_tags )
+				static_cast< const tag_t< Trait > & > ( *p ).print( writer );
+		}
+	}
 #endif
 
+	//! Forget parsed tags.
+	void clear() override
+	{
+		m_tags.clear();
+		m_current.reset();
+
+		tag_t< Trait >::clear();
+	}
+
 	//! Called when tag parsing started.
 	void on_start( const parser_info_t< Trait > & info ) override
 	{
-		m_current = std::make_shared< T > ( this->name(), this->is_mandatory() );
+		m_current = std::allocate_shared< T > (
+			typename Trait::template allocator_t< T >(),
+			this->name(), this->is_mandatory() );
 		m_current->set_parent( this->parent() );
 		m_current->on_start( info );
 	}
@@ -167,6 +213,11 @@ public:
 	void on_finish( const parser_info_t< Trait > & info ) override
 	{
 		m_current->on_finish( info );
+
+		if( info.has_error() )
+			return;
+
+		m_current->set_end_position( info );
 		m_tags.push_back( m_current );
 		m_current.reset();
 
@@ -180,6 +231,13 @@ public:
 		m_current->on_string( info, str );
 	}
 
+	//! Called when several strings in a row found.
+	void on_strings( const parser_info_t< Trait > & info,
+		const std::vector< parsed_value_t< Trait > > & values ) override
+	{
+		m_current->on_strings( info, values );
+	}
+
 private:
 	//! Vector of subordinate tags.
 	vector_of_tags_t m_tags;
@@ -14,12 +14,19 @@
 #include <cwctype>
 #include <cctype>
 #include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <new>
 #endif // CFGFILE_DISABLE_STL
 
 #ifdef CFGFILE_QT_SUPPORT
 // Qt include.
 #include <QString>
 #include <QTextStream>
+
+// C++ include.
+#include <memory>
 #endif // CFGFILE_QT_SUPPORT
 
 
@@ -27,6 +34,258 @@ namespace cfgfile {
 
 #ifndef CFGFILE_DISABLE_STL
 
+//! Default size of the arena's block.
+static const std::size_t c_arena_block_size = 64 * 1024;
+
+
+//
+// arena_t
+//
+
+/*!
+	Monotonic memory arena.
+
+	Memory is handed out from big blocks and never freed one by one,
+	all blocks are released at once with release() or in destructor.
+	Arena is not thread-safe, use one arena per parsing thread.
+*/
+class arena_t final {
+public:
+	explicit arena_t( std::size_t block_size = c_arena_block_size )
+		:	m_block_size( block_size )
+		,	m_head( nullptr )
+		,	m_pos( nullptr )
+		,	m_end( nullptr )
+		,	m_allocated( 0 )
+	{
+	}
+
+	~arena_t()
+	{
+		release();
+	}
+
+	arena_t( const arena_t & ) = delete;
+	arena_t & operator = ( const arena_t & ) = delete;
+
+	//! Allocate memory.
+	void * allocate( std::size_t bytes, std::size_t alignment )
+	{
+		char * p = align( m_pos, alignment );
+
+		if( !p || p + bytes > m_end )
+		{
+			add_block( bytes + alignment );
+
+			p = align( m_pos, alignment );
+		}
+
+		m_pos = p + bytes;
+		m_allocated += bytes;
+
+		return p;
+	}
+
+	//! Release all memory allocated by this arena.
+	void release()
+	{
+		while( m_head )
+		{
+			block_t * next = m_head->m_next;
+
+			::operator delete( m_head );
+
+			m_head = next;
+		}
+
+		m_pos = nullptr;
+		m_end = nullptr;
+		m_allocated = 0;
+	}
+
+	//! \return Amount of bytes allocated from the arena.
+	std::size_t allocated() const
+	{
+		return m_allocated;
+	}
+
+	//! \return Arena of the current thread, can be null.
+	static arena_t * current()
+	{
+		return current_ref();
+	}
+
+private:
+	friend class arena_scope_t;
+
+	static arena_t *& current_ref()
+	{
+		static thread_local arena_t * arena = nullptr;
+
+		return arena;
+	}
+
+	static char * align( char * p, std::size_t alignment )
+	{
+		if( !p )
+			return nullptr;
+
+		const std::size_t rest =
+			reinterpret_cast< std::uintptr_t > ( p ) % alignment;
+
+		return ( rest ? p + ( alignment - rest ) : p );
+	}
+
+	void add_block( std::size_t min_size )
+	{
+		const std::size_t size = ( min_size > m_block_size ?
+			min_size : m_block_size );
+
+		block_t * b = static_cast< block_t* > (
+			::operator new( sizeof( block_t ) + size ) );
+
+		b->m_next = m_head;
+		m_head = b;
+
+		m_pos = reinterpret_cast< char* > ( b + 1 );
+		m_end = m_pos + size;
+	}
+
+private:
+	//! Header of the memory block.
+	struct block_t {
+		block_t * m_next;
+		std::max_align_t m_align;
+	};
+
+	//! Size of the block.
+	std::size_t m_block_size;
+	//! List of blocks.
+	block_t * m_head;
+	//! Current position in the block.
+	char * m_pos;
+	//! End of the current block.
+	char * m_end;
+	//! Amount of allocated bytes.
+	std::size_t m_allocated;
+}; // class arena_t
+
+
+//
+// arena_scope_t
+//
+
+/*!
+	Makes the given arena current for this thread while the scope is alive.
+
+	Tags and values created in this scope with arena_string_trait_t
+	allocate from the arena, so the arena must outlive them.
+*/
+class arena_scope_t final {
+public:
+	explicit arena_scope_t( arena_t & arena )
+		:	m_prev( arena_t::current_ref() )
+	{
+		arena_t::current_ref() = &arena;
+	}
+
+	//! Null \a arena suspends current arena, i.e. global allocator is used.
+	explicit arena_scope_t( arena_t * arena )
+		:	m_prev( arena_t::current_ref() )
+	{
+		arena_t::current_ref() = arena;
+	}
+
+	~arena_scope_t()
+	{
+		arena_t::current_ref() = m_prev;
+	}
+
+	arena_scope_t( const arena_scope_t & ) = delete;
+	arena_scope_t & operator = ( const arena_scope_t & ) = delete;
+
+private:
+	//! Previous arena.
+	arena_t * m_prev;
+}; // class arena_scope_t
+
+
+//
+// arena_allocator_t
+//
+
+/*!
+	Allocator that takes memory from the current arena of the thread.
+
+	If there is no current arena the global allocator is used.
+*/
+template< typename T >
+class arena_allocator_t {
+public:
+	using value_type = T;
+
+	template< typename U >
+	struct rebind {
+		using other = arena_allocator_t< U >;
+	};
+
+	arena_allocator_t() noexcept
+		:	m_arena( arena_t::current() )
+	{
+	}
+
+	template< typename U >
+	arena_allocator_t( const arena_allocator_t< U > & other ) noexcept
+		:	m_arena( other.arena() )
+	{
+	}
+
+	T * allocate( std::size_t n )
+	{
+		if( m_arena )
+			return static_cast< T* > ( m_arena->allocate( n * sizeof( T ),
+				alignof( T ) ) );
+		else
+			return static_cast< T* > ( ::operator new( n * sizeof( T ) ) );
+	}
+
+	void deallocate( T * p, std::size_t ) noexcept
+	{
+		if( !m_arena )
+			::operator delete( p );
+	}
+
+	//! Copies of containers take memory from the current arena.
+	arena_allocator_t select_on_container_copy_construction() const
+	{
+		return arena_allocator_t();
+	}
+
+	//! \return Arena.
+	arena_t * arena() const noexcept
+	{
+		return m_arena;
+	}
+
+	template< typename U >
+	friend bool operator == ( const arena_allocator_t & a,
+		const arena_allocator_t< U > & b ) noexcept
+	{
+		return ( a.arena() == b.arena() );
+	}
+
+	template< typename U >
+	friend bool operator != ( const arena_allocator_t & a,
+		const arena_allocator_t< U > & b ) noexcept
+	{
+		return ( a.arena() != b.arena() );
+	}
+
+private:
+	//! Arena.
+	arena_t * m_arena;
+}; // class arena_allocator_t
+
 //
 // wstring_trait_t
 //
@@ -51,6 +310,10 @@ struct wstring_trait_t final {
 	//! Type of the buffer.
 	using buf_t = std::vector< char_t >;
 
+	//! Allocator for containers of the tags.
+	template< typename T >
+	using allocator_t = std::allocator< T >;
+
 	static inline string_t to_string( pos_t pos )
 	{
 		return std::to_wstring( pos );
@@ -100,6 +363,17 @@ struct wstring_trait_t final {
 		stream.seekg( 0 );
 	}
 
+	/*!
+		Seek to the character \a pos. Characters may take several bytes
+		in the file, so the stream is read from the beginning up to \a pos.
+	*/
+	static inline void seek( istream_t & stream, pos_t pos )
+	{
+		stream.clear();
+		stream.seekg( 0 );
+		stream.ignore( pos );
+	}
+
 	static inline pos_t size_of_file( istream_t & stream )
 	{
 		stream.seekg( 0, std::ios::end );
@@ -115,7 +389,7 @@ struct wstring_trait_t final {
 	{
 		pos_t actual_size = ( size - pos < buf_size ? size - pos : buf_size );
 
-		buf = buf_t( actual_size, 0x00 );
+		buf.assign( actual_size, 0x00 );
 
 		if( buf.size() > 0 )
 			stream.read( &buf[ 0 ], actual_size );
@@ -162,6 +436,10 @@ struct string_trait_t final {
 	//! Type of the buffer.
 	using buf_t = std::vector< char_t >;
 
+	//! Allocator for containers of the tags.
+	template< typename T >
+	using allocator_t = std::allocator< T >;
+
 	static inline string_t to_string( pos_t pos )
 	{
 		return std::to_string( pos );
@@ -200,7 +478,7 @@ struct string_trait_t final {
 
 	static inline bool is_space( char_t ch )
 	{
-		return ( std::isspace( (int) ch ) != 0 );
+		return ( std::isspace( static_cast< unsigned char > ( ch ) ) != 0 );
 	}
 
 	static inline void to_begin( istream_t & stream )
@@ -208,6 +486,16 @@ struct string_trait_t final {
 		stream.seekg( 0 );
 	}
 
+	/*!
+		Seek to the character \a pos, that is the position in the
+		stream, i.e. file must be opened in binary mode.
+	*/
+	static inline void seek( istream_t & stream, pos_t pos )
+	{
+		stream.clear();
+		stream.seekg( pos );
+	}
+
 	static inline pos_t size_of_file( istream_t & stream )
 	{
 		stream.seekg( 0, std::ios::end );
@@ -223,7 +511,7 @@ struct string_trait_t final {
 	{
 		pos_t actual_size = ( size - pos < buf_size ? size - pos : buf_size );
 
-		buf = buf_t( actual_size, 0x00 );
+		buf.assign( actual_size, 0x00 );
 
 		if( buf.size() > 0 )
 			stream.read( &buf[ 0 ], actual_size );
@@ -245,6 +533,103 @@ struct string_trait_t final {
 	}
 }; // struct string_trait_t
 
+
+//
+// arena_string_trait_t
+//
+
+/*!
+	Trait for std::string with memory from arena.
+
+	All strings, buffers and containers of the tags are allocated
+	from the arena that is current for the thread (see arena_scope_t),
+	so one parse can be released at once with arena_t::release().
+*/
+struct arena_string_trait_t final {
+	//! String type.
+	using string_t = std::basic_string< char, std::char_traits< char >,
+		arena_allocator_t< char > >;
+
+	//! Char type.
+	using char_t = string_t::value_type;
+
+	//! Input stream type.
+	using istream_t = std::istream;
+
+	//! Type of pos in stream.
+	using pos_t = std::streamoff;
+
+	//! Output stream type.
+	using ostream_t = std::ostream;
+
+	//! Type of the buffer.
+	using buf_t = std::vector< char_t, arena_allocator_t< char_t > >;
+
+	//! Allocator for containers of the tags.
+	template< typename T >
+	using allocator_t = arena_allocator_t< T >;
+
+	static inline string_t to_string( pos_t pos )
+	{
+		return from_ascii( std::to_string( pos ) );
+	}
+
+	static inline string_t from_ascii( const std::string & str )
+	{
+		return string_t( str.cbegin(), str.cend() );
+	}
+
+	static inline char_t from_ascii( char ch )
+	{
+		return ch;
+	}
+
+	static inline void noskipws( istream_t & stream )
+	{
+		string_trait_t::noskipws( stream );
+	}
+
+	static inline bool is_at_end( istream_t & stream )
+	{
+		return string_trait_t::is_at_end( stream );
+	}
+
+	static inline bool is_space( char_t ch )
+	{
+		return string_trait_t::is_space( ch );
+	}
+
+	static inline void to_begin( istream_t & stream )
+	{
+		string_trait_t::to_begin( stream );
+	}
+
+	static inline void seek( istream_t & stream, pos_t pos )
+	{
+		string_trait_t::seek( stream, pos );
+	}
+
+	static inline pos_t size_of_file( istream_t & stream )
+	{
+		return string_trait_t::size_of_file( stream );
+	}
+
+	static inline void fill_buf( istream_t & stream, buf_t & buf, pos_t buf_size, pos_t & pos, pos_t size )
+	{
+		pos_t actual_size = ( size - pos < buf_size ? size - pos : buf_size );
+
+		buf.assign( actual_size, 0x00 );
+
+		if( buf.size() > 0 )
+			stream.read( &buf[ 0 ], actual_size );
+
+		while( !buf.empty() && buf.back() == 0x00 )
+			buf.pop_back();
+
+		pos += actual_size;
+	}
+}; // struct arena_string_trait_t
+
 #endif // CFGFILE_DISABLE_STL
 
 
@@ -494,6 +879,10 @@ struct qstring_trait_t final {
 	//! Type of the buffer.
 	using buf_t = QString;
 
+	//! Allocator for containers of the tags.
+	template< typename T >
+	using allocator_t = std::allocator< T >;
+
 	static inline string_t to_string( pos_t pos )
 	{
 		return QString::number( pos );
@@ -528,14 +917,30 @@ struct qstring_trait_t final {
 		stream.seek( 0 );
 	}
 
-	static inline pos_t size_of_file( istream_t & stream )
+	/*!
+		Seek to the character \a pos. Position of QTextStream on the
+		device is in bytes, so the stream is read from the beginning
+		up to \a pos.
+	*/
+	static inline void seek( istream_t & stream, pos_t pos )
+	{
+		stream.seek( 0 );
+		stream.read( pos );
+	}
+
+	static inline pos_t size_of_file( istream_t & )
 	{
 		return 0;
 	}
 
-	static inline void fill_buf( istream_t & stream, buf_t & buf, pos_t buf_size, pos_t & pos, pos_t size )
+	/*!
+		The rest of the stream is read and decoded at once, so the
+		input stream indexes one QString instead of allocating a new
+		string for each chunk.
+	*/
+	static inline void fill_buf( istream_t & stream, buf_t & buf, pos_t, pos_t & pos, pos_t )
 	{
-		buf = stream.read( buf_size );
+		buf = stream.readAll();
 		pos += buf.size();
 	}
 }; // struct qstring_trait_t
@@ -557,6 +962,20 @@ using string_trait_t = qstring_trait_t;
 	Class( const Class & ) = delete; \
 	Class & operator= ( const Class & ) = delete;
 
+
+//
+// CFGFILE_COLD
+//
+
+//! Marks function as rarely called, i.e. code that throws.
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define CFGFILE_COLD __attribute__(( noinline, cold ))
+#elif defined( _MSC_VER )
+#define CFGFILE_COLD __declspec( noinline )
+#else
+#define CFGFILE_COLD
+#endif
+
 } /* namespace cfgfile */
 
 #endif // CFGFILE__TYPES_HPP__INCLUDED
@@ -18,6 +18,8 @@
 // Qt include.
 #include <QDomDocument>
 #include <QDomElement>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 #endif
 
 
@@ -79,6 +81,68 @@ private:
 	typename Trait::istream_t & m_stream;
 }; // class determine_format_t
 
+
+//
+// read_xml
+//
+
+//! Read configuration file in XML format with xml_reader_t.
+template< typename Trait >
+static inline void read_xml( tag_t< Trait > & tag,
+	typename Trait::istream_t & stream,
+	const typename Trait::string_t & file_name,
+	const parse_limits_t & limits )
+{
+	input_stream_t< Trait > is( file_name, stream );
+
+	xml_reader_t< Trait > reader( is );
+
+	parser_t< Trait > parser( tag, reader );
+
+	parser.set_limits( limits );
+	parser.parse( file_name );
+}
+
+#ifdef CFGFILE_QT_SUPPORT
+/*!
+	Read configuration file in XML format with QXmlStreamReader.
+
+	QXmlStreamReader decodes a device by itself, as UTF-8 or by the
+	XML declaration. So the device is read directly only when the
+	stream is in UTF-8 too, otherwise the text is decoded by the stream.
+*/
+static inline void read_xml( tag_t< qstring_trait_t > & tag,
+	qstring_trait_t::istream_t & stream,
+	const qstring_trait_t::string_t & file_name,
+	const parse_limits_t & limits )
+{
+#ifdef CFGFILE_XML_SUPPORT
+	QIODevice * device = ( stream.encoding() == QStringConverter::Utf8 ?
+		stream.device() : nullptr );
+
+	// Device is read by chunks, string streams have no device.
+	QXmlStreamReader reader( device ? QString() : stream.readAll() );
+
+	if( device )
+		reader.setDevice( device );
+
+	parser_t< qstring_trait_t > parser( tag, reader );
+
+	parser.set_limits( limits );
+	parser.parse( file_name );
+#else
+	Q_UNUSED( tag )
+	Q_UNUSED( stream )
+	Q_UNUSED( file_name )
+	Q_UNUSED( limits )
+
+	throw exception_t< qstring_trait_t >(
+		qstring_trait_t::from_ascii( "To use XML format build cfgfile "
+			"with CFGFILE_XML_SUPPORT" ) );
+#endif // CFGFILE_XML_SUPPORT
+}
+#endif // CFGFILE_QT_SUPPORT
+
 } /* namespace details */
 
 
@@ -94,7 +158,9 @@ static inline void read_cfgfile(
 	//! Stream.
 	typename Trait::istream_t & stream,
 	//! File name.
-	const typename Trait::string_t & file_name )
+	const typename Trait::string_t & file_name,
+	//! Limits of the parsing, there are no limits by default.
+	const parse_limits_t & limits = parse_limits_t() )
 {
 	file_format_t fmt = file_format_t::cfgfile_format;
 
@@ -114,54 +180,274 @@ static inline void read_cfgfile(
 
 			parser_t< Trait > parser( tag, is );
 
+			parser.set_limits( limits );
 			parser.parse( file_name );
 		}
 			break;
 
 		case file_format_t::xml_format :
-		{
-#ifdef CFGFILE_QT_SUPPORT
-#ifdef CFGFILE_XML_SUPPORT
-			QDomDocument doc;
+			details::read_xml( tag, stream, file_name, limits );
+			break;
+	}
+}
 
-			QString error;
-			int line = 0;
-			int column = 0;
 
-			const QString data = stream.readAll();
+/*!
+	Read cfgfile configuration file reusing \a context between calls.
 
-			if( !doc.setContent( data, true, &error, &line, &column ) )
-				throw exception_t< Trait >( QString( "Unable to parse XML "
-					"from file: \"%1\". \"%2\" On line %3, column %4." )
-						.arg( file_name )
-						.arg( error )
-						.arg( QString::number( line ) )
-						.arg( QString::number( column ) ) );
+	Limits of the \a context are applied to both formats.
+*/
+template< typename Trait = string_trait_t >
+static inline void read_cfgfile(
+	//! Configuration tag.
+	tag_t< Trait > & tag,
+	//! Stream.
+	typename Trait::istream_t & stream,
+	//! File name.
+	const typename Trait::string_t & file_name,
+	//! Parser context.
+	parser_context_t< Trait > & context )
+{
+	file_format_t fmt = file_format_t::cfgfile_format;
 
-			parser_t< Trait > parser( tag, doc );
+	{
+		details::determine_format_t< Trait > d( stream );
 
-			parser.parse( file_name );
-#else
-			throw exception_t< Trait >(
-				Trait::from_ascii( "To use XML format build cfgfile "
-					"with CFGFILE_XML_SUPPORT" ) );
-#endif // CFGFILE_XML_SUPPORT
-#else
-			throw exception_t< Trait >(
-				Trait::from_ascii( "XML supported only with Qt. Parsing of file \"" ) +
-				file_name + Trait::from_ascii( "\" failed." ) );
-#endif // CFGFILE_QT_SUPPORT
+		fmt = d.format();
+	}
+
+	Trait::to_begin( stream );
+
+	if( fmt == file_format_t::xml_format )
+		read_cfgfile( tag, stream, file_name, context.limits() );
+	else
+	{
+		context.reset( stream, file_name );
+		context.parse( tag );
+	}
+}
+
+
+//
+// try_read_cfgfile
+//
+
+/*!
+	Read cfgfile configuration file without throwing exceptions.
+
+	In cfgfile format the lexer, the parser and the built-in tags and
+	formats report errors without exceptions. Exceptions thrown by
+	user's tags and formats, and by XML parsing, are caught.
+
+	\return Result of the parsing.
+*/
+template< typename Trait = string_trait_t >
+static inline parse_result_t< Trait > try_read_cfgfile(
+	//! Configuration tag.
+	tag_t< Trait > & tag,
+	//! Stream.
+	typename Trait::istream_t & stream,
+	//! File name.
+	const typename Trait::string_t & file_name,
+	//! Limits of the parsing, there are no limits by default.
+	const parse_limits_t & limits = parse_limits_t() )
+{
+	file_format_t fmt = file_format_t::cfgfile_format;
+
+	{
+		details::determine_format_t< Trait > d( stream );
+
+		fmt = d.format();
+	}
+
+	Trait::to_begin( stream );
+
+	if( fmt == file_format_t::xml_format )
+	{
+		try {
+			read_cfgfile( tag, stream, file_name, limits );
 		}
-			break;
+		catch( const exception_t< Trait > & x )
+		{
+			return parse_result_t< Trait >( x );
+		}
+
+		return parse_result_t< Trait >();
 	}
+
+	input_stream_t< Trait > is( file_name, stream );
+
+	parser_t< Trait > parser( tag, is );
+
+	parser.set_limits( limits );
+
+	return parser.try_parse( file_name );
 }
 
 
+//
+// validate_cfgfile
+//
+
+/*!
+	Read cfgfile configuration file and collect all errors in one pass.
+
+	In cfgfile format the rest of the tag with error is skipped up to
+	its finish curl brace and parsing goes on. In XML format only the
+	first error is reported.
+
+	\return Found errors, empty if there are no errors.
+*/
+template< typename Trait = string_trait_t >
+static inline std::vector< parse_result_t< Trait > > validate_cfgfile(
+	//! Configuration tag.
+	tag_t< Trait > & tag,
+	//! Stream.
+	typename Trait::istream_t & stream,
+	//! File name.
+	const typename Trait::string_t & file_name,
+	//! Limits of the parsing, there are no limits by default.
+	const parse_limits_t & limits = parse_limits_t() )
+{
+	file_format_t fmt = file_format_t::cfgfile_format;
+
+	{
+		details::determine_format_t< Trait > d( stream );
+
+		fmt = d.format();
+	}
+
+	Trait::to_begin( stream );
+
+	if( fmt == file_format_t::xml_format )
+	{
+		std::vector< parse_result_t< Trait > > errors;
+
+		const parse_result_t< Trait > result =
+			try_read_cfgfile( tag, stream, file_name, limits );
+
+		if( !result )
+			errors.push_back( result );
+
+		return errors;
+	}
+
+	input_stream_t< Trait > is( file_name, stream );
+
+	parser_t< Trait > parser( tag, is );
+
+	parser.set_limits( limits );
+
+	return parser.validate( file_name );
+}
+
+
+//
+// reparse_cfgfile
+//
+
+/*!
+	Read cfgfile configuration file again after the edit without
+	throwing exceptions.
+
+	The \a tag must be read before from the text before the \a edit,
+	the \a stream contains the whole text after the edit. Only the
+	smallest tag enclosing the edit is parsed again and the result is
+	put into the existing tree, so the time doesn't depend on the
+	size of the file. If the edit changed the structure of this tag
+	its parent is parsed, up to the whole file.
+
+	Only cfgfile format is supported. Tags in tag_vector_of_tags_t
+	are parsed again with the parent of the vector.
+
+	Positions are counted in characters. std::istream is positioned
+	with seekg(), so files must be opened in binary mode. Wide and Qt
+	streams are read again from the beginning up to the tag, since
+	their characters may take several bytes.
+
+	\return Result of the parsing.
+*/
+template< typename Trait = string_trait_t >
+static inline parse_result_t< Trait > reparse_cfgfile(
+	//! Configuration tag.
+	tag_t< Trait > & tag,
+	//! Stream with the text after the edit.
+	typename Trait::istream_t & stream,
+	//! File name.
+	const typename Trait::string_t & file_name,
+	//! Edit.
+	const text_edit_t< Trait > & edit )
+{
+	input_stream_t< Trait > is( file_name, stream );
+
+	parser_t< Trait > parser( tag, is );
+
+	return parser.try_reparse( file_name, edit );
+}
+
+
+#ifndef CFGFILE_DISABLE_STL
+
+//
+// read_utf8_cfgfile
+//
+
+/*!
+	Read cfgfile configuration file in UTF-8 into std::wstring tags.
+
+	The file is lexed as bytes, only values are decoded. XML
+	format is not supported here.
+
+	Only ASCII white spaces are skipped before the first tag, unlike
+	std::wistream input where std::iswspace() skips any Unicode space.
+*/
+static inline void read_utf8_cfgfile(
+	//! Configuration tag.
+	tag_t< wstring_trait_t > & tag,
+	//! Stream with UTF-8 data.
+	std::istream & stream,
+	//! File name in UTF-8.
+	const std::string & file_name )
+{
+	file_format_t fmt = file_format_t::cfgfile_format;
+
+	{
+		details::determine_format_t< string_trait_t > d( stream );
+
+		fmt = d.format();
+	}
+
+	string_trait_t::to_begin( stream );
+
+	if( fmt == file_format_t::xml_format )
+		throw exception_t< wstring_trait_t >(
+			wstring_trait_t::from_ascii( "XML is not supported with UTF-8 "
+				"input. Parsing of file \"" ) +
+			details::utf8_to_wstring( file_name ) +
+			wstring_trait_t::from_ascii( "\" failed." ) );
+
+	input_stream_t< string_trait_t > is( file_name, stream );
+
+	parser_t< wstring_trait_t > parser( tag, is );
+
+	parser.parse( details::utf8_to_wstring( file_name ) );
+}
+
+#endif // CFGFILE_DISABLE_STL
+
+
 //
 // write_cfgfile
 //
 
-//! Write cfgfile configuration file.
+/*!
+	Write cfgfile configuration file.
+
+	XML is written with QXmlStreamWriter, that always writes UTF-8
+	to a device. So it writes straight to the device of the stream only
+	when the stream is in UTF-8, otherwise the text goes through the
+	stream and gets its encoding.
+*/
 template< typename Trait >
 static inline void write_cfgfile(
 	//! Configuration tag.
@@ -185,11 +471,25 @@ static inline void write_cfgfile(
 		{
 #ifdef CFGFILE_QT_SUPPORT
 #ifdef CFGFILE_XML_SUPPORT
-			QDomDocument doc;
+			stream.flush();
+
+			QIODevice * device = ( stream.encoding() == QStringConverter::Utf8 ?
+				stream.device() : nullptr );
+			QString data;
+
+			const std::unique_ptr< QXmlStreamWriter > writer = ( device ?
+				std::make_unique< QXmlStreamWriter >( device ) :
+				std::make_unique< QXmlStreamWriter >( &data ) );
+
+			writer->setAutoFormatting( true );
+			writer->setAutoFormattingIndent( 4 );
+
+			tag.print( *writer );
 
-			tag.print( doc );
+			writer->writeEndDocument();
 
-			stream << doc.toString( 4 );
+			if( !device )
+				stream << data;
 #else
 			throw exception_t< Trait >(
 				Trait::from_ascii( "To use XML format build cfgfile "
@@ -0,0 +1,739 @@
+
+/*
+	SPDX-FileCopyrightText: 2017-2024 Igor Mironchik <igor.mironchik@gmail.com>
+	SPDX-License-Identifier: MIT
+*/
+
+#ifndef CFGFILE__XML_READER_HPP__INCLUDED
+#define CFGFILE__XML_READER_HPP__INCLUDED
+
+// cfgfile include.
+#include "types.hpp"
+#include "const.hpp"
+#include "input_stream.hpp"
+#include "exceptions.hpp"
+#include "name_table.hpp"
+#include "parser_info.hpp"
+
+// C++ include.
+#include <cstdint>
+#include <vector>
+
+
+namespace cfgfile {
+
+//
+// xml_token_type_t
+//
+
+//! Type of the token of XML.
+enum class xml_token_type_t {
+	//! End of the document.
+	end_of_document,
+	//! Start of the element.
+	start_element,
+	//! End of the element.
+	end_element,
+	//! Text or CDATA.
+	characters,
+	//! Processing instruction inside of the root element.
+	processing_instruction
+}; // enum class xml_token_type_t
+
+
+//
+// xml_attribute_t
+//
+
+//! Attribute of the element.
+template< typename Trait = string_trait_t >
+struct xml_attribute_t {
+	//! Name.
+	typename Trait::string_t m_name;
+	//! Value with replaced references.
+	typename Trait::string_t m_value;
+}; // struct xml_attribute_t
+
+
+//
+// xml_reader_t
+//
+
+/*!
+	Non-validating pull parser of XML.
+
+	Reads elements, attributes, text and CDATA from input_stream_t.
+	XML declaration, comments, DOCTYPE and processing instructions
+	outside of the root element are skipped. Predefined entities and
+	character references are replaced. Only names of the open
+	elements are kept, strings of the tokens are reused.
+
+	Positions are like in QXmlStreamReader: line and amount of
+	characters read on the line after the token.
+
+	Limits of the size of the input and of the length of names,
+	values of attributes and text are checked while reading.
+*/
+template< typename Trait = string_trait_t >
+class xml_reader_t final {
+public:
+	explicit xml_reader_t( input_stream_t< Trait > & stream )
+		:	m_stream( stream )
+		,	m_attributes_count( 0 )
+		,	m_is_whitespace( false )
+		,	m_is_empty_element( false )
+		,	m_is_root_read( false )
+		,	m_has_error( false )
+	{
+	}
+
+	/*!
+		Read next token.
+
+		\throw exception_t< Trait > if XML is malformed.
+	*/
+	xml_token_type_t read_next()
+	{
+		if( m_is_empty_element )
+		{
+			m_is_empty_element = false;
+
+			return finish_element();
+		}
+
+		while( true )
+		{
+			if( m_stream.at_end() )
+			{
+				if( !m_is_root_read )
+					fail( "Premature end of document." );
+
+				return xml_token_type_t::end_of_document;
+			}
+
+			const typename Trait::char_t ch = read_char();
+
+			if( ch != Trait::from_ascii( '<' ) )
+			{
+				if( m_open.empty() )
+				{
+					if( !is_space( ch ) )
+						fail( m_is_root_read ? "Extra content at end of document." :
+							"Start tag expected." );
+
+					continue;
+				}
+
+				m_stream.put_back( ch );
+
+				read_text();
+
+				return xml_token_type_t::characters;
+			}
+
+			const typename Trait::char_t next = get();
+
+			if( next == Trait::from_ascii( '/' ) )
+				return read_end_tag();
+			else if( next == Trait::from_ascii( '?' ) )
+			{
+				read_processing_instruction();
+
+				if( !m_open.empty() )
+					return xml_token_type_t::processing_instruction;
+			}
+			else if( next == Trait::from_ascii( '!' ) )
+			{
+				if( read_declaration() )
+					return xml_token_type_t::characters;
+			}
+			else
+			{
+				m_stream.put_back( next );
+
+				return read_start_tag();
+			}
+		}
+	}
+
+	/*!
+		\return Name of the element for start_element and end_element,
+		target for processing_instruction.
+	*/
+	const typename Trait::string_t & name() const
+	{
+		return m_name;
+	}
+
+	//! \return Text for characters.
+	const typename Trait::string_t & text() const
+	{
+		return m_text;
+	}
+
+	//! \return Is text only of white spaces?
+	bool is_whitespace() const
+	{
+		return m_is_whitespace;
+	}
+
+	//! \return Amount of attributes for start_element.
+	std::size_t attributes_count() const
+	{
+		return m_attributes_count;
+	}
+
+	//! \return Attribute with the \a index.
+	const xml_attribute_t< Trait > & attribute( std::size_t index ) const
+	{
+		return m_attributes[ index ];
+	}
+
+	//! \return Line number.
+	typename Trait::pos_t line_number() const
+	{
+		return m_stream.line_number();
+	}
+
+	//! \return Amount of characters read on the line.
+	typename Trait::pos_t column_number() const
+	{
+		return m_stream.column_number() - 1;
+	}
+
+	//! \return Was malformed XML found or a limit exceeded?
+	bool has_error() const
+	{
+		return m_has_error;
+	}
+
+	//! Set limits of the size and the length of the lexemes.
+	void set_limits( const parse_limits_t & limits )
+	{
+		m_limits = limits;
+	}
+
+private:
+	//! Throw exception on malformed XML.
+	void fail( const typename Trait::string_t & desc )
+	{
+		m_has_error = true;
+
+		throw exception_t< Trait >(
+			Trait::from_ascii( "Unable to parse XML from file: \"" ) +
+			m_stream.file_name() + Trait::from_ascii( "\". \"" ) + desc +
+			Trait::from_ascii( "\" On line " ) + Trait::to_string( line_number() ) +
+			Trait::from_ascii( ", column " ) + Trait::to_string( column_number() ) +
+			Trait::from_ascii( "." ) );
+	}
+
+	//! Throw exception on malformed XML.
+	void fail( const char * desc )
+	{
+		fail( Trait::from_ascii( desc ) );
+	}
+
+	//! Throw exception on exceeded limit with the \a name.
+	CFGFILE_COLD void fail_limit( const char * name )
+	{
+		m_has_error = true;
+
+		details::throw_error< Trait >( error_code_t::limit_exceeded,
+			m_stream.file_name(), line_number(), column_number(),
+			typename Trait::string_t(), Trait::from_ascii( name ) );
+	}
+
+	//! \return Next character, checks the size of the input.
+	typename Trait::char_t read_char()
+	{
+		if( m_limits.m_max_size &&
+			static_cast< std::size_t > ( m_stream.offset() ) >=
+				m_limits.m_max_size )
+					fail_limit( "size" );
+
+		return m_stream.get();
+	}
+
+	//! Append the \a ch to the \a to, checks the length of the lexeme.
+	void append( typename Trait::string_t & to, typename Trait::char_t ch )
+	{
+		if( m_limits.m_max_lexeme_length &&
+			static_cast< std::size_t > ( to.size() ) >=
+				m_limits.m_max_lexeme_length )
+					fail_limit( "lexeme length" );
+
+		to.push_back( ch );
+	}
+
+	//! \return Next character, throws at the end of the stream.
+	typename Trait::char_t get()
+	{
+		if( m_stream.at_end() )
+			fail( "Premature end of document." );
+
+		return read_char();
+	}
+
+	//! \return Is character a space character?
+	static bool is_space( typename Trait::char_t ch )
+	{
+		const details::char_class_t c = const_t< Trait >::char_class( ch );
+
+		return ( c == details::char_class_t::space ||
+			c == details::char_class_t::new_line );
+	}
+
+	//! Skip spaces.
+	void skip_spaces()
+	{
+		typename Trait::char_t ch = get();
+
+		while( is_space( ch ) )
+			ch = get();
+
+		m_stream.put_back( ch );
+	}
+
+	//! Read name to the \a to.
+	void read_name( typename Trait::string_t & to )
+	{
+		to.clear();
+
+		while( !m_stream.at_end() )
+		{
+			const typename Trait::char_t ch = read_char();
+
+			if( is_space( ch ) || ch == Trait::from_ascii( '/' ) ||
+				ch == Trait::from_ascii( '>' ) || ch == Trait::from_ascii( '=' ) ||
+				ch == Trait::from_ascii( '?' ) || ch == Trait::from_ascii( '<' ) )
+			{
+				m_stream.put_back( ch );
+
+				break;
+			}
+
+			append( to, ch );
+		}
+
+		if( to.empty() )
+			fail( "Invalid XML name." );
+	}
+
+	//! Read start tag with attributes.
+	xml_token_type_t read_start_tag()
+	{
+		if( m_is_root_read )
+			fail( "Extra content at end of document." );
+
+		if( m_limits.m_max_depth && m_open.size() >= m_limits.m_max_depth )
+			fail_limit( "depth" );
+
+		read_name( m_name );
+
+		m_attributes_count = 0;
+
+		while( true )
+		{
+			skip_spaces();
+
+			const typename Trait::char_t ch = get();
+
+			if( ch == Trait::from_ascii( '>' ) )
+				break;
+			else if( ch == Trait::from_ascii( '/' ) )
+			{
+				if( get() != Trait::from_ascii( '>' ) )
+					fail( "Expected '>'." );
+
+				m_is_empty_element = true;
+
+				break;
+			}
+
+			m_stream.put_back( ch );
+
+			read_attribute();
+		}
+
+		m_open.push_back( m_name );
+
+		return xml_token_type_t::start_element;
+	}
+
+	//! Read attribute.
+	void read_attribute()
+	{
+		if( m_attributes.size() == m_attributes_count )
+			m_attributes.push_back( xml_attribute_t< Trait >() );
+
+		xml_attribute_t< Trait > & attr = m_attributes[ m_attributes_count ];
+
+		++m_attributes_count;
+
+		read_name( attr.m_name );
+
+		skip_spaces();
+
+		if( get() != Trait::from_ascii( '=' ) )
+			fail( "Expected '='." );
+
+		skip_spaces();
+
+		const typename Trait::char_t quote = get();
+
+		if( quote != Trait::from_ascii( '"' ) &&
+			quote != Trait::from_ascii( '\'' ) )
+				fail( "Expected quotes." );
+
+		attr.m_value.clear();
+
+		while( true )
+		{
+			const typename Trait::char_t ch = get();
+
+			if( ch == quote )
+				break;
+			else if( ch == Trait::from_ascii( '<' ) )
+				fail( "Invalid character '<' in attribute value." );
+			else if( ch == Trait::from_ascii( '&' ) )
+				read_reference( attr.m_value );
+			// White spaces in the values are normalized.
+			else if( is_space( ch ) )
+				append( attr.m_value, const_t< Trait >::c_space );
+			else
+				append( attr.m_value, ch );
+		}
+	}
+
+	//! Read end tag.
+	xml_token_type_t read_end_tag()
+	{
+		read_name( m_name );
+
+		skip_spaces();
+
+		if( get() != Trait::from_ascii( '>' ) )
+			fail( "Expected '>'." );
+
+		if( m_open.empty() || !( m_open.back() == m_name ) )
+			fail( "Opening and ending tag mismatch." );
+
+		return finish_element();
+	}
+
+	//! Close the last open element.
+	xml_token_type_t finish_element()
+	{
+		m_open.pop_back();
+
+		if( m_open.empty() )
+			m_is_root_read = true;
+
+		return xml_token_type_t::end_element;
+	}
+
+	//! Read text up to the next markup.
+	void read_text()
+	{
+		m_text.clear();
+		m_is_whitespace = true;
+
+		while( !m_stream.at_end() )
+		{
+			const typename Trait::char_t ch = read_char();
+
+			if( ch == Trait::from_ascii( '<' ) )
+			{
+				m_stream.put_back( ch );
+
+				break;
+			}
+			else if( ch == Trait::from_ascii( '&' ) )
+			{
+				read_reference( m_text );
+
+				m_is_whitespace = false;
+			}
+			else
+			{
+				if( !is_space( ch ) )
+					m_is_whitespace = false;
+
+				append( m_text, ch );
+			}
+		}
+	}
+
+	//! Read processing instruction after "<?".
+	void read_processing_instruction()
+	{
+		read_name( m_name );
+
+		typename Trait::char_t prev( 0x00 );
+
+		while( true )
+		{
+			const typename Trait::char_t ch = get();
+
+			if( prev == Trait::from_ascii( '?' ) && ch == Trait::from_ascii( '>' ) )
+				break;
+
+			prev = ch;
+		}
+	}
+
+	/*!
+		Read comment, CDATA or DOCTYPE after "<!".
+
+		\return true if CDATA was read into the text.
+	*/
+	bool read_declaration()
+	{
+		typename Trait::char_t ch = get();
+
+		if( ch == Trait::from_ascii( '-' ) )
+		{
+			if( get() != Trait::from_ascii( '-' ) )
+				fail( "Invalid comment." );
+
+			skip_up_to( Trait::from_ascii( '-' ), nullptr );
+
+			return false;
+		}
+		else if( ch == Trait::from_ascii( '[' ) )
+		{
+			static const char cdata[] = "CDATA[";
+
+			for( const char * c = cdata; *c; ++c )
+			{
+				if( get() != Trait::from_ascii( *c ) )
+					fail( "Invalid CDATA section." );
+			}
+
+			if( m_open.empty() )
+				fail( "Start tag expected." );
+
+			skip_up_to( Trait::from_ascii( ']' ), &m_text );
+
+			m_is_whitespace = true;
+
+			for( const typename Trait::char_t & c : m_text )
+			{
+				if( !is_space( c ) )
+				{
+					m_is_whitespace = false;
+
+					break;
+				}
+			}
+
+			return true;
+		}
+
+		if( !m_open.empty() || m_is_root_read )
+			fail( "Unexpected declaration." );
+
+		// DOCTYPE, internal subset in square brackets may contain ">".
+		int depth = 0;
+
+		while( true )
+		{
+			if( ch == Trait::from_ascii( '[' ) )
+				++depth;
+			else if( ch == Trait::from_ascii( ']' ) )
+				--depth;
+			else if( ch == Trait::from_ascii( '>' ) && depth <= 0 )
+				break;
+
+			ch = get();
+		}
+
+		return false;
+	}
+
+	/*!
+		Read up to the two \a end characters followed by ">",
+		i.e. "-->" or "]]>". Read characters are stored in the \a to.
+	*/
+	void skip_up_to( typename Trait::char_t end, typename Trait::string_t * to )
+	{
+		if( to )
+			to->clear();
+
+		typename Trait::char_t prev1( 0x00 );
+		typename Trait::char_t prev2( 0x00 );
+
+		while( true )
+		{
+			const typename Trait::char_t ch = get();
+
+			if( ch == Trait::from_ascii( '>' ) && prev1 == end && prev2 == end )
+			{
+				if( to )
+					to->resize( to->size() - 2 );
+
+				break;
+			}
+
+			if( to )
+				append( *to, ch );
+
+			prev2 = prev1;
+			prev1 = ch;
+		}
+	}
+
+	//! Read reference after "&" and append its character to the \a to.
+	void read_reference( typename Trait::string_t & to )
+	{
+		m_reference.clear();
+
+		while( true )
+		{
+			const typename Trait::char_t ch = get();
+
+			if( ch == Trait::from_ascii( ';' ) )
+				break;
+
+			if( m_reference.size() > c_max_reference_length )
+				fail( "Invalid entity." );
+
+			m_reference.push_back( ch );
+		}
+
+		if( m_reference == Trait::from_ascii( "lt" ) )
+			append( to, Trait::from_ascii( '<' ) );
+		else if( m_reference == Trait::from_ascii( "gt" ) )
+			append( to, Trait::from_ascii( '>' ) );
+		else if( m_reference == Trait::from_ascii( "amp" ) )
+			append( to, Trait::from_ascii( '&' ) );
+		else if( m_reference == Trait::from_ascii( "quot" ) )
+			append( to, Trait::from_ascii( '"' ) );
+		else if( m_reference == Trait::from_ascii( "apos" ) )
+			append( to, Trait::from_ascii( '\'' ) );
+		else if( !m_reference.empty() &&
+			m_reference[ 0 ] == Trait::from_ascii( '#' ) )
+				append_code_point( to, character_reference() );
+		else
+			fail( Trait::from_ascii( "Entity '" ) + m_reference +
+				Trait::from_ascii( "' not declared." ) );
+	}
+
+	//! \return Code point of the character reference "#N" or "#xN".
+	std::uint32_t character_reference()
+	{
+		std::size_t i = 1;
+		std::uint32_t base = 10;
+
+		if( m_reference.size() > 1 &&
+			m_reference[ 1 ] == Trait::from_ascii( 'x' ) )
+		{
+			base = 16;
+			i = 2;
+		}
+
+		if( i == m_reference.size() )
+			fail( "Invalid character reference." );
+
+		std::uint32_t cp = 0;
+
+		for( ; i < m_reference.size(); ++i )
+		{
+			const std::size_t c = details::char_code( m_reference[ i ] );
+			std::uint32_t digit = base;
+
+			if( c >= '0' && c <= '9' )
+				digit = static_cast< std::uint32_t > ( c - '0' );
+			else if( c >= 'a' && c <= 'f' )
+				digit = static_cast< std::uint32_t > ( c - 'a' + 10 );
+			else if( c >= 'A' && c <= 'F' )
+				digit = static_cast< std::uint32_t > ( c - 'A' + 10 );
+
+			if( digit >= base )
+				fail( "Invalid character reference." );
+
+			cp = cp * base + digit;
+		}
+
+		if( cp == 0 || cp > 0x10FFFF || ( cp >= 0xD800 && cp <= 0xDFFF ) )
+			fail( "Invalid character reference." );
+
+		return cp;
+	}
+
+	/*!
+		Append the \a cp to the \a to, in UTF-8 for the narrow
+		characters, with surrogate pair for 16-bit characters.
+		Length of the lexeme is checked.
+	*/
+	void append_code_point( typename Trait::string_t & to,
+		std::uint32_t cp )
+	{
+		using char_t = typename Trait::char_t;
+
+		if( sizeof( char_t ) == 1 && cp >= 0x80 )
+		{
+			if( cp < 0x800 )
+				append( to, static_cast< char_t > ( 0xC0 | ( cp >> 6 ) ) );
+			else
+			{
+				if( cp < 0x10000 )
+					append( to, static_cast< char_t > ( 0xE0 | ( cp >> 12 ) ) );
+				else
+				{
+					append( to, static_cast< char_t > ( 0xF0 | ( cp >> 18 ) ) );
+					append( to, static_cast< char_t > (
+						0x80 | ( ( cp >> 12 ) & 0x3F ) ) );
+				}
+
+				append( to, static_cast< char_t > (
+					0x80 | ( ( cp >> 6 ) & 0x3F ) ) );
+			}
+
+			append( to, static_cast< char_t > ( 0x80 | ( cp & 0x3F ) ) );
+		}
+		else if( sizeof( char_t ) == 2 && cp >= 0x10000 )
+		{
+			cp -= 0x10000;
+			append( to, static_cast< char_t > ( 0xD800 + ( cp >> 10 ) ) );
+			append( to, static_cast< char_t > ( 0xDC00 + ( cp & 0x3FF ) ) );
+		}
+		else
+			append( to, static_cast< char_t > ( cp ) );
+	}
+
+private:
+	DISABLE_COPY( xml_reader_t )
+
+	//! Max length of the reference between "&" and ";".
+	static const std::size_t c_max_reference_length = 16;
+
+	//! Input stream.
+	input_stream_t< Trait > & m_stream;
+	//! Names of the open elements.
+	std::vector< typename Trait::string_t > m_open;
+	//! Name.
+	typename Trait::string_t m_name;
+	//! Text.
+	typename Trait::string_t m_text;
+	//! Reference.
+	typename Trait::string_t m_reference;
+	//! Attributes, only first m_attributes_count are actual.
+	std::vector< xml_attribute_t< Trait > > m_attributes;
+	//! Amount of the attributes.
+	std::size_t m_attributes_count;
+	//! Is text only of white spaces?
+	bool m_is_whitespace;
+	//! Was the start tag "<name/>"?
+	bool m_is_empty_element;
+	//! Is the root element closed?
+	bool m_is_root_read;
+	//! Was malformed XML found or a limit exceeded?
+	bool m_has_error;
+	//! Limits.
+	parse_limits_t m_limits;
+}; // class xml_reader_t
+
+} /* namespace cfgfile */
+
+#endif // CFGFILE__XML_READER_HPP__INCLUDED
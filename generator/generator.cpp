@@ -93,7 +93,9 @@ static inline void generate_includes( std::ostream & stream,
 		"#include <cfgfile/all.hpp>\n\n";
 
 	stream << "// C++ include.\n"
-		<< "#include <vector>\n\n";
+		<< "#include <vector>\n"
+		<< "#include <algorithm>\n"
+		<< "#include <iterator>\n\n";
 
 	for( const std::string & incl : global_includes )
 		stream << "#include <" << incl << ">\n";
@@ -203,36 +205,6 @@ static inline void generate_fields_in_ctor( std::ostream & stream,
 				<< f.name() << std::string( "\" ), " )
 				<< bool_to_string( f.is_required() )
 				<< std::string( " )\n" );
-
-			if( !f.is_constraint_null() )
-			{
-				cfg::constraint_base_t * constr = f.constraint().get();
-
-				switch( constr->type() )
-				{
-					case cfg::constraint_base_t::min_max_constraint_type :
-					{
-						cfg::min_max_constraint_t * min_max =
-							static_cast< cfg::min_max_constraint_t* > ( constr );
-
-						stream << std::string( "\t\t,\tm_" )
-							<< f.name() << std::string( "_constraint( " )
-							<< min_max->min() << std::string( ", " )
-							<< min_max->max() << std::string( " )\n" );
-					}
-						break;
-
-					case cfg::constraint_base_t::one_of_constraint_type :
-					{
-						stream << std::string( "\t\t,\tm_" )
-							<< f.name() << std::string( "_constraint()\n" );
-					}
-						break;
-
-					default :
-						break;
-				}
-			}
 		}
 	}
 } // generate_fields_in_ctor
@@ -249,48 +221,13 @@ static inline void generate_constraints_in_ctor( std::ostream & stream,
 	{
 		if( !f.is_constraint_null() )
 		{
-			cfg::constraint_base_t * constr = f.constraint().get();
-
-			switch( constr->type() )
-			{
-				case cfg::constraint_base_t::min_max_constraint_type :
-				{
-					if( !f.is_base() )
-						stream << std::string( "\t\tm_" )
-							<< f.name() << std::string( ".set_constraint( &m_" )
-							<< f.name() << std::string( "_constraint );\n\n" );
-					else
-						stream << std::string( "\t\tthis->set_constraint( &m_" )
-							<< f.name() << std::string( "_constraint );\n\n" );
-				}
-					break;
-
-				case cfg::constraint_base_t::one_of_constraint_type :
-				{
-					cfg::one_of_constraint_t * one_of =
-						static_cast< cfg::one_of_constraint_t* > ( constr );
-
-					for( const std::string & s : one_of->values() )
-					{
-						stream << std::string( "\t\tm_" )
-							<< f.name()
-							<< std::string( "_constraint.add_value( " )
-							<< s << std::string( " );\n" );
-					}
-
-					if( !f.is_base() )
-						stream << std::string( "\t\tm_" )
-							<< f.name() << std::string( ".set_constraint( &m_" )
-							<< f.name() << std::string( "_constraint );\n\n" );
-					else
-						stream << std::string( "\t\tthis->set_constraint( &m_" )
-							<< f.name() << std::string( "_constraint );\n\n" );
-				}
-					break;
-
-				default :
-					break;
-			}
+			if( !f.is_base() )
+				stream << std::string( "\t\tm_" )
+					<< f.name() << std::string( ".set_constraint( &check_" )
+					<< f.name() << std::string( " );\n\n" );
+			else
+				stream << std::string( "\t\tthis->set_constraint( &check_" )
+					<< f.name() << std::string( " );\n\n" );
 		}
 	}
 } // generate_constraints_in_ctor
@@ -645,6 +582,97 @@ static inline void generate_cfg_set( std::ostream & stream,
 } // generate_cfg_set
 
 
+//
+// generate_constraint_checks
+//
+
+static inline void generate_constraint_checks( std::ostream & stream,
+	cfg::const_class_ptr_t c )
+{
+	for( const cfg::field_t & f : c->fields() )
+	{
+		if( !f.is_constraint_null() )
+		{
+			cfg::constraint_base_t * constr = f.constraint().get();
+
+			switch( constr->type() )
+			{
+				case cfg::constraint_base_t::min_max_constraint_type :
+				{
+					cfg::min_max_constraint_t * min_max =
+						static_cast< cfg::min_max_constraint_t* > ( constr );
+
+					stream << std::string( "\tstatic bool check_" )
+						<< f.name() << std::string( "( const " )
+						<< f.value_type() << std::string( " & value )\n"
+							"\t{\n"
+							"\t\treturn ( static_cast< " )
+						<< f.value_type() << std::string( " > ( " )
+						<< min_max->min() << std::string( " ) <= value &&\n"
+							"\t\t\tvalue <= static_cast< " )
+						<< f.value_type() << std::string( " > ( " )
+						<< min_max->max() << std::string( " ) );\n"
+							"\t}\n\n" );
+				}
+					break;
+
+				case cfg::constraint_base_t::one_of_constraint_type :
+				{
+					cfg::one_of_constraint_t * one_of =
+						static_cast< cfg::one_of_constraint_t* > ( constr );
+
+					// Small lists are scanned, as in constraint_one_of_t.
+					const bool linear = ( one_of->values().size() <= 8 );
+
+					stream << std::string( "\tstatic bool check_" )
+						<< f.name() << std::string( "( const " )
+						<< f.value_type() << std::string( " & value )\n"
+							"\t{\n" );
+
+					if( linear )
+						stream << std::string( "\t\tstatic const " )
+							<< f.value_type() << std::string( " values[] = {" );
+					else
+						stream << std::string( "\t\tstatic const std::vector< " )
+							<< f.value_type() << std::string( " > values = [] () {\n"
+								"\t\t\tstd::vector< " )
+							<< f.value_type() << std::string( " > v = {" );
+
+					bool first = true;
+
+					for( const std::string & s : one_of->values() )
+					{
+						stream << ( first ? std::string( " " ) : std::string( ", " ) )
+							<< s;
+
+						first = false;
+					}
+
+					if( linear )
+						stream << std::string( " };\n\n"
+							"\t\treturn ( std::find( std::begin( values ), "
+							"std::end( values ), value ) !=\n"
+							"\t\t\tstd::end( values ) );\n"
+							"\t}\n\n" );
+					else
+						stream << std::string( " };\n\n"
+							"\t\t\tstd::sort( v.begin(), v.end() );\n\n"
+							"\t\t\treturn v;\n"
+							"\t\t} ();\n\n"
+							"\t\treturn std::binary_search( values.cbegin(), "
+							"values.cend(), value );\n"
+							"\t}\n\n" );
+				}
+					break;
+
+				default :
+					break;
+			}
+		}
+	}
+} // generate_constraint_checks
+
+
 //
 // generate_private_tag_members
 //
@@ -704,33 +732,6 @@ static inline void generate_private_tag_members( std::ostream & stream,
 					break;
 			}
 		}
-
-		if( !f.is_constraint_null() )
-		{
-			cfg::constraint_base_t * constr = f.constraint().get();
-
-			switch( constr->type() )
-			{
-				case cfg::constraint_base_t::min_max_constraint_type :
-				{
-					stream << std::string( "\tcfgfile::constraint_min_max_t< " )
-						<< f.value_type() << std::string( " > m_" )
-						<< f.name() << std::string( "_constraint;\n" );
-				}
-					break;
-
-				case cfg::constraint_base_t::one_of_constraint_type :
-				{
-					stream << std::string( "\tcfgfile::constraint_one_of_t< " )
-						<< f.value_type() << std::string( " > m_" )
-						<< f.name() << std::string( "_constraint;\n" );
-				}
-					break;
-
-				default :
-					break;
-			}
-		}
 	}
 } // generate_private_tag_members
 
@@ -857,6 +858,8 @@ static inline void generate_tag_class( std::ostream & stream,
 	// private members.
 	stream << std::string( "private:\n" );
 
+	generate_constraint_checks( stream, c );
+
 	generate_private_tag_members( stream, c );
 
 	stream << std::string( "}; // class " )
@@ -149,19 +149,22 @@ TEST_CASE( "testEmptyFile" )
 	}
 } // testEmptyFile
 
-TEST_CASE( "testUnsupportedXML" )
+TEST_CASE( "testXML" )
 {
-	try {
-		loadConfig( "xml.cfg" );
+	Configuration cfg = loadConfig( "xml.cfg" );
 
-		REQUIRE( false );
-	}
-	catch( const cfgfile::exception_t<> & x )
-	{
-		REQUIRE( "XML supported only with Qt. Parsing of file "
-			"\"xml.cfg\" failed." == x.desc() );
-	}
-}
+	REQUIRE( cfg.m_stringValue == "string" );
+	REQUIRE( cfg.m_listOfStringValues.size() == 3 );
+	REQUIRE( cfg.m_listOfStringValues.at( 0 ) == "str1" );
+	REQUIRE( cfg.m_listOfStringValues.at( 1 ) == "str2" );
+	REQUIRE( cfg.m_listOfStringValues.at( 2 ) == "str3" );
+	REQUIRE( cfg.m_intValue == 100 );
+	REQUIRE( cfg.m_vectorOfTags.size() == 2 );
+	REQUIRE( cfg.m_vectorOfTags.at( 0 ).m_stringValue == "str1" );
+	REQUIRE( cfg.m_vectorOfTags.at( 0 ).m_intValue == 10 );
+	REQUIRE( cfg.m_vectorOfTags.at( 1 ).m_stringValue == "str2" );
+	REQUIRE( cfg.m_vectorOfTags.at( 1 ).m_intValue == 20 );
+} // testXML
 
 TEST_CASE( "testUnsupportedXMLWrite" )
 {
@@ -559,6 +559,18 @@ TEST_CASE( "test_to_cfg_file_format" )
 
 	REQUIRE( to_cfgfile_format< string_trait_t > ( "\"\n\r\t\\a" ) ==
 		"\"\\\"\\n\\r\\t\\\\a\"" );
+
+	REQUIRE( to_cfgfile_format< string_trait_t > ( "a|b#c" ) == "a|b#c" );
+	REQUIRE( to_cfgfile_format< string_trait_t > ( "a b" ) == "\"a b\"" );
+	REQUIRE( to_cfgfile_format< string_trait_t > ( "a{" ) == "\"a{\"" );
+	REQUIRE( to_cfgfile_format< string_trait_t > ( "a||" ) == "\"a||\"" );
+	REQUIRE( to_cfgfile_format< string_trait_t > ( "|#a" ) == "\"|#a\"" );
+	REQUIRE( to_cfgfile_format< string_trait_t > ( "a#|" ) == "\"a#|\"" );
+
+	REQUIRE( to_cfgfile_format< wstring_trait_t > ( L"\u0442\t\u0435" ) ==
+		L"\"\u0442\\t\u0435\"" );
+	REQUIRE( from_cfgfile_format< wstring_trait_t > (
+		L"\"\u0442\\t\u0435\"" ) == L"\u0442\t\u0435" );
 }
 
 TEST_CASE( "test_from_cfg_file_format" )
@@ -592,3 +604,49 @@ TEST_CASE( "test_from_cfg_file_format" )
 
 	REQUIRE( from_cfgfile_format< string_trait_t > ( "abc" ) == "abc" );
 }
+
+TEST_CASE( "testDoubleRoundTrip" )
+{
+	parser_info_t< string_trait_t > ps( "test.cfg", 1, 1 );
+	parser_info_t< wstring_trait_t > pw( L"test.cfg", 1, 1 );
+
+	const double values[] = { 0.1, 1234.9876, -2.5e-300, 1.7976931348623157e308,
+		4.9406564584124654e-324, 1.0 / 3.0, 123456789012345678.0, 100.0, -0.0 };
+
+	for( const double v : values )
+	{
+		const auto str = format_t< double, string_trait_t >::to_string( v );
+
+		REQUIRE( format_t< double, string_trait_t >::from_string( ps, str ) == v );
+
+		const auto wstr = format_t< double, wstring_trait_t >::to_string( v );
+
+		REQUIRE( format_t< double, wstring_trait_t >::from_string( pw, wstr ) == v );
+	}
+
+	REQUIRE( format_t< double, string_trait_t >::to_string( 0.1 ) == "0.1" );
+	REQUIRE( format_t< double, string_trait_t >::to_string( 100.0 ) == "100" );
+	REQUIRE( format_t< double, string_trait_t >::from_string( ps, "1.5e3" ) == 1500.0 );
+	REQUIRE( format_t< double, string_trait_t >::from_string( ps,
+		"0.30000000000000004" ) == 0.1 + 0.2 );
+	REQUIRE( std::signbit( format_t< double, string_trait_t >::from_string( ps, "-0" ) ) );
+
+	try {
+		format_t< double, string_trait_t >::from_string( ps, "1.5x" );
+
+		REQUIRE( false );
+	}
+	catch( const exception_t< string_trait_t > & x )
+	{
+		REQUIRE( x.desc() == "Invalid value: \"1.5x\". In file \"test.cfg\" on line 1." );
+	}
+
+	try {
+		format_t< double, string_trait_t >::from_string( ps, "1e999" );
+
+		REQUIRE( false );
+	}
+	catch( const exception_t< string_trait_t > & )
+	{
+	}
+}
@@ -6,6 +6,7 @@
 
 // C++ include.
 #include <fstream>
+#include <sstream>
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 // doctest include.
@@ -105,3 +106,56 @@ TEST_CASE( "testAllIsOk" )
 
 	check_config( cfg );
 } // testAllIsOk
+
+TEST_CASE( "testConstraints" )
+{
+	{
+		cfg::tag_int_scalar_t< cfgfile::string_trait_t > tag;
+
+		std::stringstream stream( "{int_scalar 200 {string_field three}}" );
+
+		cfgfile::read_cfgfile( tag, stream, "testConstraints" );
+
+		REQUIRE( tag.get_cfg().int_scalar() == 200 );
+		REQUIRE( tag.get_cfg().string_field() == "three" );
+	}
+
+	{
+		cfg::tag_int_scalar_t< cfgfile::string_trait_t > tag;
+
+		std::stringstream stream( "{int_scalar 200 {string_field three} "
+			"{many_values 900}}" );
+
+		cfgfile::read_cfgfile( tag, stream, "testConstraints" );
+
+		REQUIRE( tag.get_cfg().many_values() == 900 );
+	}
+
+	{
+		cfg::tag_int_scalar_t< cfgfile::string_trait_t > tag;
+
+		std::stringstream stream( "{int_scalar 200 {string_field three} "
+			"{many_values 901}}" );
+
+		REQUIRE_THROWS_AS( cfgfile::read_cfgfile( tag, stream, "testConstraints" ),
+			cfgfile::exception_t<> );
+	}
+
+	{
+		cfg::tag_int_scalar_t< cfgfile::string_trait_t > tag;
+
+		std::stringstream stream( "{int_scalar 201 {string_field three}}" );
+
+		REQUIRE_THROWS_AS( cfgfile::read_cfgfile( tag, stream, "testConstraints" ),
+			cfgfile::exception_t<> );
+	}
+
+	{
+		cfg::tag_int_scalar_t< cfgfile::string_trait_t > tag;
+
+		std::stringstream stream( "{int_scalar 100 {string_field four}}" );
+
+		REQUIRE_THROWS_AS( cfgfile::read_cfgfile( tag, stream, "testConstraints" ),
+			cfgfile::exception_t<> );
+	}
+} // testConstraints
@@ -6,6 +6,8 @@
 
 // C++ include.
 #include <sstream>
+#include <vector>
+#include <algorithm>
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 // doctest include.
@@ -104,3 +106,92 @@ TEST_CASE( "testInputStream" )
 
 	REQUIRE( in.at_end() );
 }
+
+TEST_CASE( "testPositionsOnBufferBoundary" )
+{
+	std::stringstream stream( std::string( c_buff_size - 1, 'a' ) +
+		"\r\nb\nc" );
+
+	input_stream_t<> in( "test", stream );
+
+	for( std::size_t i = 0; i < c_buff_size - 1; ++i )
+		REQUIRE( in.get() == 'a' );
+
+	REQUIRE( in.column_number() == 512 );
+	REQUIRE( in.line_number() == 1 );
+	REQUIRE( in.get() == '\n' );
+
+	REQUIRE( in.offset() == 513 );
+	REQUIRE( in.column_number() == 1 );
+	REQUIRE( in.line_number() == 2 );
+	REQUIRE( in.get() == 'b' );
+	REQUIRE( in.get() == '\n' );
+
+	in.put_back( '\n' );
+
+	REQUIRE( in.column_number() == 2 );
+	REQUIRE( in.line_number() == 2 );
+	REQUIRE( in.get() == '\n' );
+
+	REQUIRE( in.column_number() == 1 );
+	REQUIRE( in.line_number() == 3 );
+	REQUIRE( in.get() == 'c' );
+
+	REQUIRE( in.at_end() );
+
+	REQUIRE( in.line_number( 5 ) == 1 );
+	REQUIRE( in.column_number( 5 ) == 6 );
+	REQUIRE( in.line_number( 514 ) == 2 );
+	REQUIRE( in.column_number( 514 ) == 2 );
+}
+
+TEST_CASE( "testPositionsOfManyBuffers" )
+{
+	std::string data;
+	std::vector< std::streamoff > starts( 1, 0 );
+
+	for( std::size_t i = 0; i < 2000; ++i )
+	{
+		data.append( i % 7 + 1, 'a' );
+
+		switch( i % 3 )
+		{
+			case 0 :
+				data.append( "\n" );
+				break;
+
+			case 1 :
+				data.append( "\r\n" );
+				break;
+
+			default :
+				data.append( "\r" );
+				break;
+		}
+
+		starts.push_back( (std::streamoff) data.size() );
+	}
+
+	std::stringstream stream( data );
+
+	input_stream_t<> in( "test", stream );
+
+	while( !in.at_end() )
+		in.get();
+
+	for( std::size_t offset = 0; offset <= data.size(); ++offset )
+	{
+		// Offset between "\r" and "\n" is never reached.
+		if( offset > 0 && offset < data.size() && data[ offset - 1 ] == '\r' &&
+			data[ offset ] == '\n' )
+				continue;
+
+		const std::size_t line = static_cast< std::size_t > ( std::upper_bound(
+			starts.cbegin(), starts.cend(), (std::streamoff) offset ) -
+				starts.cbegin() );
+
+		REQUIRE( in.line_number( offset ) == (std::streamoff) line );
+		REQUIRE( in.column_number( offset ) ==
+			(std::streamoff) offset - starts[ line - 1 ] + 1 );
+	}
+}
@@ -420,3 +420,42 @@ TEST_CASE( "test_finishedMmultiComment" )
 
 	REQUIRE( lex4.type() == cfgfile::lexeme_type_t::null );
 }
+
+TEST_CASE( "test_commentsOnBufferBoundary" )
+{
+	// "#|" is split between two buffers.
+	std::stringstream stream( "{a |#\n" +
+		std::string( cfgfile::c_buff_size - 7, 'x' ) + "#|b}\n"
+		"|| " + std::string( cfgfile::c_buff_size, 'y' ) + "\n"
+		"c}" );
+
+	cfgfile::input_stream_t<> input( "test_commentsOnBufferBoundary", stream );
+	cfgfile::lexical_analyzer_t<> analyzer( input );
+
+	auto lex1 = analyzer.next_lexeme();
+	REQUIRE( lex1.type() == cfgfile::lexeme_type_t::start );
+
+	auto lex2 = analyzer.next_lexeme();
+	REQUIRE( lex2.type() == cfgfile::lexeme_type_t::string );
+	REQUIRE( lex2.value() == "a" );
+
+	auto lex3 = analyzer.next_lexeme();
+	REQUIRE( lex3.type() == cfgfile::lexeme_type_t::string );
+	REQUIRE( lex3.value() == "b" );
+
+	auto lex4 = analyzer.next_lexeme();
+	REQUIRE( lex4.type() == cfgfile::lexeme_type_t::finish );
+	REQUIRE( analyzer.line_number() == 2 );
+	REQUIRE( analyzer.column_number() ==
+		static_cast< std::streamoff > ( cfgfile::c_buff_size - 3 ) );
+
+	auto lex5 = analyzer.next_lexeme();
+	REQUIRE( lex5.type() == cfgfile::lexeme_type_t::string );
+	REQUIRE( lex5.value() == "c" );
+
+	auto lex6 = analyzer.next_lexeme();
+	REQUIRE( lex6.type() == cfgfile::lexeme_type_t::finish );
+	REQUIRE( analyzer.line_number() == 4 );
+	REQUIRE( analyzer.column_number() == 2 );
+	REQUIRE( input.at_end() );
+}
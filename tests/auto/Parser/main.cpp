@@ -1346,3 +1346,1315 @@ TEST_CASE( "test_determineFormat" )
 		REQUIRE( fmt.format() == cfgfile::file_format_t::cfgfile_format );
 	}
 } // test_determineFormat
+
+TEST_CASE( "test_arena_string_trait" )
+{
+	using trait_t = cfgfile::arena_string_trait_t;
+
+	cfgfile::arena_t arena;
+
+	{
+		cfgfile::arena_scope_t scope( arena );
+
+		cfgfile::tag_no_value_t< trait_t > cfg(
+			trait_t::from_ascii( "cfg" ), true );
+		cfgfile::tag_scalar_t< int, trait_t > i( cfg,
+			trait_t::from_ascii( "int" ), true );
+		cfgfile::tag_scalar_vector_t< trait_t::string_t, trait_t > v( cfg,
+			trait_t::from_ascii( "values" ), true );
+
+		std::stringstream stream( "{cfg {int 100} "
+			"{values \"long long long long string\" str2}}" );
+
+		cfgfile::read_cfgfile< trait_t >( cfg, stream,
+			trait_t::from_ascii( "test_arena_string_trait" ) );
+
+		REQUIRE( cfg.is_defined() );
+		REQUIRE( i.value() == 100 );
+		REQUIRE( v.size() == 2 );
+		REQUIRE( v.at( 0 ) == "long long long long string" );
+		REQUIRE( v.at( 1 ) == "str2" );
+		REQUIRE( v.values().get_allocator().arena() == &arena );
+		REQUIRE( arena.allocated() > 0 );
+	}
+
+	arena.release();
+
+	REQUIRE( arena.allocated() == 0 );
+	REQUIRE( cfgfile::arena_t::current() == nullptr );
+} // test_arena_string_trait
+
+TEST_CASE( "test_interned_names" )
+{
+	cfgfile::tag_no_value_t<> cfg( "cfg", true );
+	cfgfile::tag_vector_of_tags_t< cfgfile::tag_scalar_t< int > > v(
+		cfg, "value", true );
+	cfgfile::tag_scalar_t< int > other( "value" );
+
+	REQUIRE( v.has_same_name( other ) );
+	REQUIRE( &v.name() == &other.name() );
+	REQUIRE( !cfg.has_same_name( other ) );
+
+	std::stringstream stream( "{cfg {value 1} {value 2}}" );
+
+	cfgfile::read_cfgfile( cfg, stream, "test_interned_names" );
+
+	REQUIRE( v.size() == 2 );
+	REQUIRE( &v.at( 0 ).name() == &v.at( 1 ).name() );
+	REQUIRE( &v.at( 0 ).name() == &v.name() );
+} // test_interned_names
+
+TEST_CASE( "test_constraint_one_of" )
+{
+	cfgfile::constraint_one_of_t< int > small = { 3, 1, 2, 2 };
+
+	REQUIRE( small.check( 1 ) );
+	REQUIRE( small.check( 3 ) );
+	REQUIRE( !small.check( 4 ) );
+
+	small.remove_value( 2 );
+
+	REQUIRE( !small.check( 2 ) );
+
+	cfgfile::constraint_one_of_t< std::string > big;
+
+	for( int i = 20; i > 0; --i )
+		big.add_value( std::to_string( i ) );
+
+	big.add_value( "10" );
+
+	for( int i = 1; i <= 20; ++i )
+		REQUIRE( big.check( std::to_string( i ) ) );
+
+	REQUIRE( !big.check( "0" ) );
+	REQUIRE( !big.check( "21" ) );
+
+	big.remove_value( "15" );
+
+	REQUIRE( !big.check( "15" ) );
+	REQUIRE( big.check( "16" ) );
+} // test_constraint_one_of
+
+TEST_CASE( "test_tag_scalar_vector_strings_run" )
+{
+	std::string data = "{cfg";
+
+	for( int i = 0; i < 1000; ++i )
+		data.append( " " ).append( std::to_string( i ) );
+
+	data.append( "\n1000 abc}" );
+
+	std::stringstream stream( data );
+
+	cfgfile::input_stream_t<> input( "test_tag_scalar_vector_strings_run", stream );
+
+	cfgfile::tag_scalar_vector_t< int > tag( "cfg", true );
+
+	cfgfile::parser_t<> parser( tag, input );
+
+	try {
+		parser.parse( "test_tag_scalar_vector_strings_run" );
+
+		REQUIRE( false );
+	}
+	catch( cfgfile::exception_t<> & x )
+	{
+		REQUIRE( x.desc() == "Invalid value: \"abc\". In file "
+			"\"test_tag_scalar_vector_strings_run\" on line 2." );
+	}
+
+	REQUIRE( tag.values().size() == 1001 );
+	REQUIRE( tag.values().front() == 0 );
+	REQUIRE( tag.values().back() == 1000 );
+} // test_tag_scalar_vector_strings_run
+
+TEST_CASE( "test_utf8_input_for_wstring" )
+{
+	std::stringstream stream( "{cfg \"\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82 "
+		"world, \xF0\x9F\x99\x82\" {child 42}}" );
+
+	cfgfile::tag_scalar_t< std::wstring, cfgfile::wstring_trait_t > tag(
+		L"cfg", true );
+	cfgfile::tag_scalar_t< int, cfgfile::wstring_trait_t > child(
+		tag, L"child", true );
+
+	cfgfile::read_utf8_cfgfile( tag, stream, "test_utf8_input_for_wstring" );
+
+	std::wstring expected = L"\x041F\x0440\x0438\x0432\x0435\x0442 world, ";
+
+	if( sizeof( wchar_t ) == 2 )
+		expected.append( { wchar_t( 0xD83D ), wchar_t( 0xDE42 ) } );
+	else
+		expected.push_back( wchar_t( 0x1F642 ) );
+
+	REQUIRE( tag.value() == expected );
+	REQUIRE( child.value() == 42 );
+
+	std::stringstream wrong( "{cfg \"\xD0\x9F" );
+
+	cfgfile::tag_scalar_t< std::wstring, cfgfile::wstring_trait_t > other(
+		L"cfg", true );
+
+	try {
+		cfgfile::read_utf8_cfgfile( other, wrong, "wrong" );
+
+		REQUIRE( false );
+	}
+	catch( const cfgfile::exception_t< cfgfile::wstring_trait_t > & x )
+	{
+		REQUIRE( x.desc() == L"Unfinished quoted lexeme. End of file riched. "
+			L"In file \"wrong\" on line 1." );
+	}
+} // test_utf8_input_for_wstring
+
+TEST_CASE( "test_parser_context" )
+{
+	cfgfile::parser_context_t<> context;
+
+	{
+		std::stringstream stream( "{cfg 1 2 3" );
+
+		cfgfile::tag_scalar_vector_t< int > tag( "cfg", true );
+
+		context.reset( stream, "first" );
+
+		try {
+			context.parse( tag );
+
+			REQUIRE( false );
+		}
+		catch( const cfgfile::exception_t<> & x )
+		{
+			REQUIRE( x.desc() == "Unexpected end of file. "
+				"Still unfinished tag \"cfg\"." );
+		}
+	}
+
+	for( int i = 0; i < 3; ++i )
+	{
+		std::stringstream stream( "{cfg\n  {child " + std::to_string( i ) +
+			"}\n}" );
+
+		cfgfile::tag_no_value_t<> tag( "cfg", true );
+		cfgfile::tag_scalar_t< int > child( tag, "child", true );
+
+		cfgfile::read_cfgfile( tag, stream, "second", context );
+
+		REQUIRE( child.value() == i );
+	}
+
+	{
+		std::stringstream stream( "{cfg\n{wrong}}" );
+
+		cfgfile::tag_no_value_t<> tag( "cfg", true );
+
+		context.reset( stream, "third" );
+
+		try {
+			context.parse( tag );
+
+			REQUIRE( false );
+		}
+		catch( const cfgfile::exception_t<> & x )
+		{
+			REQUIRE( x.desc() == "Unexpected tag name. We expected one child tag "
+				"of tag \"cfg\", but we've got \"wrong\". In file \"third\" "
+				"on line 2." );
+		}
+	}
+} // test_parser_context
+
+TEST_CASE( "test_parser_info_source" )
+{
+	cfgfile::source_t<> source( "test.cfg" );
+
+	const cfgfile::parser_info_t<> info( source, 1, 2 );
+
+	REQUIRE( &info.file_name() == &source.file_name() );
+
+	const cfgfile::parser_info_t<> copy = info;
+
+	REQUIRE( &copy.file_name() == &source.file_name() );
+
+	cfgfile::parser_info_t<> own( std::string( "own.cfg" ), 3, 4 );
+
+	const cfgfile::parser_info_t<> own_copy = own;
+
+	REQUIRE( own_copy.file_name() == "own.cfg" );
+	REQUIRE( own_copy.line_number() == 3 );
+	REQUIRE( own_copy.column_number() == 4 );
+} // test_parser_info_source
+
+TEST_CASE( "test_structured_error" )
+{
+	std::stringstream stream( "{cfg\n  {child abc}}" );
+
+	cfgfile::input_stream_t<> input( "test_structured_error", stream );
+
+	cfgfile::tag_no_value_t<> tag( "cfg", true );
+	cfgfile::tag_scalar_t< int > child( tag, "child", true );
+
+	cfgfile::parser_t<> parser( tag, input );
+
+	try {
+		parser.parse( "test_structured_error" );
+
+		REQUIRE( false );
+	}
+	catch( const cfgfile::exception_t<> & x )
+	{
+		REQUIRE( x.code() == cfgfile::error_code_t::invalid_value );
+		REQUIRE( x.file_name() == "test_structured_error" );
+		REQUIRE( x.line_number() == 2 );
+		REQUIRE( x.column_number() == 10 );
+		REQUIRE( x.token() == "abc" );
+		REQUIRE( std::string( x.what() ) == "Invalid value: \"abc\". In file "
+			"\"test_structured_error\" on line 2." );
+		REQUIRE( x.desc() == x.what() );
+	}
+} // test_structured_error
+
+TEST_CASE( "test_try_read_cfgfile" )
+{
+	const char * inputs[] = {
+		"{cfg {child 1}}",
+		"{cfg {child 1}",
+		"{cfg {child \"1}}",
+		"{cfg {child \"\\q\"}}",
+		"{cfg {wrong 1}}",
+		"{wrong {child 1}}",
+		"cfg {child 1}}",
+		"{cfg {{child 1}}",
+		"{cfg {child abc}}",
+		"{cfg {child 99999999999}}",
+		"{cfg {child \"\"}}",
+		"{cfg {child 1 2}}",
+		"{cfg {child 1}} 2",
+		""
+	};
+
+	for( const char * data : inputs )
+	{
+		cfgfile::tag_no_value_t<> tag( "cfg", true );
+		cfgfile::tag_scalar_t< int > child( tag, "child", true );
+
+		std::stringstream stream( data );
+
+		const cfgfile::parse_result_t<> result =
+			cfgfile::try_read_cfgfile( tag, stream, "test" );
+
+		cfgfile::tag_no_value_t<> other_tag( "cfg", true );
+		cfgfile::tag_scalar_t< int > other_child( other_tag, "child", true );
+
+		std::stringstream other_stream( data );
+
+		try {
+			cfgfile::read_cfgfile( other_tag, other_stream, "test" );
+
+			REQUIRE( result.ok() );
+		}
+		catch( const cfgfile::exception_t<> & x )
+		{
+			REQUIRE( !result );
+			REQUIRE( result.code() == x.code() );
+			REQUIRE( result.desc() == x.desc() );
+			REQUIRE( result.line_number() == x.line_number() );
+		}
+	}
+} // test_try_read_cfgfile
+
+TEST_CASE( "test_tag_errors_to_sink" )
+{
+	cfgfile::details::error_t< cfgfile::string_trait_t > error;
+
+	cfgfile::source_t<> source( "test" );
+	source.set_error_sink( &error );
+
+	const cfgfile::parser_info_t<> info( source, 3, 4 );
+
+	{
+		cfgfile::tag_scalar_t< unsigned int > tag( "a", true );
+
+		REQUIRE_NOTHROW( tag.on_string( info, "4294967296" ) );
+		REQUIRE( info.has_error() );
+		REQUIRE( error.code() == cfgfile::error_code_t::invalid_value );
+		REQUIRE( error.line_number() == 3 );
+		REQUIRE( error.column_number() == 4 );
+		REQUIRE( !tag.is_defined() );
+	}
+
+	error = cfgfile::details::error_t< cfgfile::string_trait_t >();
+
+	{
+		cfgfile::tag_scalar_vector_t< int > tag( "a", true );
+
+		std::vector< cfgfile::parsed_value_t<> > values;
+		values.push_back( { "1", 3, 4 } );
+		values.push_back( { "x", 3, 6 } );
+
+		REQUIRE_NOTHROW( tag.on_strings( info, values ) );
+		REQUIRE( error.code() == cfgfile::error_code_t::invalid_value );
+		REQUIRE( error.token() == "x" );
+		REQUIRE( error.column_number() == 6 );
+	}
+
+	error = cfgfile::details::error_t< cfgfile::string_trait_t >();
+
+	{
+		cfgfile::tag_no_value_t<> tag( "a", true );
+		cfgfile::tag_scalar_t< bool > child( tag, "b", true );
+
+		REQUIRE_NOTHROW( tag.on_string( info, "1" ) );
+		REQUIRE( error.code() == cfgfile::error_code_t::value_is_not_allowed );
+
+		error = cfgfile::details::error_t< cfgfile::string_trait_t >();
+
+		REQUIRE_NOTHROW( child.on_string( info, "maybe" ) );
+		REQUIRE( error.code() == cfgfile::error_code_t::invalid_value );
+
+		error = cfgfile::details::error_t< cfgfile::string_trait_t >();
+
+		REQUIRE_NOTHROW( tag.on_finish( info ) );
+		REQUIRE( error.code() ==
+			cfgfile::error_code_t::undefined_child_mandatory_tag );
+	}
+
+	source.set_error_sink( nullptr );
+
+	{
+		cfgfile::tag_scalar_t< int > tag( "a", true );
+
+		REQUIRE_THROWS_AS( tag.on_string( info, "abc" ),
+			cfgfile::exception_t<> );
+	}
+} // test_tag_errors_to_sink
+
+TEST_CASE( "test_validate_cfgfile" )
+{
+	{
+		const std::string data =
+			"{cfg\n"
+			"  {a abc}\n"
+			"  {unknown {x 1} 2}\n"
+			"  {b 2}\n"
+			"  {c 1 {d 1}}\n"
+			"  {e 1 2}\n"
+			"}";
+
+		cfgfile::tag_no_value_t<> tag( "cfg", true );
+		cfgfile::tag_scalar_t< int > a( tag, "a", true );
+		cfgfile::tag_scalar_t< int > b( tag, "b", true );
+		cfgfile::tag_scalar_t< int > c( tag, "c", true );
+		cfgfile::tag_scalar_t< int > e( tag, "e", true );
+
+		std::stringstream stream( data );
+
+		const std::vector< cfgfile::parse_result_t<> > errors =
+			cfgfile::validate_cfgfile( tag, stream, "test" );
+
+		REQUIRE( errors.size() == 4 );
+
+		REQUIRE( errors.at( 0 ).code() ==
+			cfgfile::error_code_t::invalid_value );
+		REQUIRE( errors.at( 0 ).line_number() == 2 );
+
+		REQUIRE( errors.at( 1 ).code() ==
+			cfgfile::error_code_t::unexpected_child_tag_name );
+		REQUIRE( errors.at( 1 ).line_number() == 3 );
+
+		REQUIRE( errors.at( 2 ).code() ==
+			cfgfile::error_code_t::unexpected_child_tag_name );
+		REQUIRE( errors.at( 2 ).line_number() == 5 );
+
+		REQUIRE( errors.at( 3 ).code() ==
+			cfgfile::error_code_t::value_already_defined );
+		REQUIRE( errors.at( 3 ).line_number() == 6 );
+
+		REQUIRE( b.value() == 2 );
+	}
+
+	{
+		cfgfile::tag_no_value_t<> tag( "cfg", true );
+		cfgfile::tag_scalar_t< int > child( tag, "child", true );
+
+		std::stringstream stream( "{cfg {child 1}}" );
+
+		REQUIRE( cfgfile::validate_cfgfile( tag, stream, "test" ).empty() );
+		REQUIRE( child.value() == 1 );
+	}
+
+	{
+		cfgfile::tag_no_value_t<> tag( "cfg", true );
+		cfgfile::tag_scalar_t< int > child( tag, "child", true );
+
+		std::stringstream stream( "{cfg {wrong 1} {child \"1}}" );
+
+		const std::vector< cfgfile::parse_result_t<> > errors =
+			cfgfile::validate_cfgfile( tag, stream, "test" );
+
+		REQUIRE( errors.size() == 2 );
+		REQUIRE( errors.at( 0 ).code() ==
+			cfgfile::error_code_t::unexpected_child_tag_name );
+		REQUIRE( errors.at( 1 ).code() ==
+			cfgfile::error_code_t::end_of_file_in_quoted_lexeme );
+	}
+
+	{
+		cfgfile::tag_no_value_t<> tag( "cfg", true );
+		cfgfile::tag_scalar_t< int > child( tag, "child", true );
+
+		std::stringstream stream( "{cfg {wrong 1}" );
+
+		const std::vector< cfgfile::parse_result_t<> > errors =
+			cfgfile::validate_cfgfile( tag, stream, "test" );
+
+		REQUIRE( errors.size() == 2 );
+		REQUIRE( errors.at( 1 ).code() ==
+			cfgfile::error_code_t::unfinished_tag );
+	}
+} // test_validate_cfgfile
+
+TEST_CASE( "test_error_in_strings_before_lexical_error" )
+{
+	const std::string data = "{cfg {ints 1 x \"2";
+
+	{
+		cfgfile::tag_no_value_t<> tag( "cfg", true );
+		cfgfile::tag_scalar_vector_t< int > ints( tag, "ints", true );
+
+		std::stringstream stream( data );
+
+		try {
+			cfgfile::read_cfgfile( tag, stream, "test" );
+
+			REQUIRE( false );
+		}
+		catch( const cfgfile::exception_t<> & x )
+		{
+			REQUIRE( x.code() == cfgfile::error_code_t::invalid_value );
+		}
+	}
+
+	{
+		cfgfile::tag_no_value_t<> tag( "cfg", true );
+		cfgfile::tag_scalar_vector_t< int > ints( tag, "ints", true );
+
+		std::stringstream stream( data );
+
+		const cfgfile::parse_result_t<> result =
+			cfgfile::try_read_cfgfile( tag, stream, "test" );
+
+		REQUIRE( result.code() == cfgfile::error_code_t::invalid_value );
+	}
+
+	{
+		cfgfile::tag_no_value_t<> tag( "cfg", true );
+		cfgfile::tag_scalar_vector_t< int > ints( tag, "ints", true );
+
+		std::stringstream stream( data );
+
+		const std::vector< cfgfile::parse_result_t<> > errors =
+			cfgfile::validate_cfgfile( tag, stream, "test" );
+
+		REQUIRE( errors.size() == 2 );
+		REQUIRE( errors.at( 0 ).code() ==
+			cfgfile::error_code_t::invalid_value );
+		REQUIRE( errors.at( 1 ).code() ==
+			cfgfile::error_code_t::end_of_file_in_quoted_lexeme );
+	}
+} // test_error_in_strings_before_lexical_error
+
+class CountedScalarTag
+	:	public cfgfile::tag_scalar_t< int >
+{
+public:
+	CountedScalarTag( tag_t<> & owner, const std::string & name )
+		:	cfgfile::tag_scalar_t< int >( owner, name, true )
+		,	m_starts( 0 )
+	{
+	}
+
+	void on_start( const cfgfile::parser_info_t<> & info ) override
+	{
+		++m_starts;
+
+		cfgfile::tag_scalar_t< int >::on_start( info );
+	}
+
+	int m_starts;
+}; // class CountedScalarTag
+
+struct ReparseConfig {
+	ReparseConfig()
+		:	m_cfg( "cfg", true )
+		,	m_first( m_cfg, "first", true )
+		,	m_a( m_first, "a" )
+		,	m_list( m_first, "list", true )
+		,	m_second( m_cfg, "second", true )
+		,	m_b( m_second, "b" )
+		,	m_c( m_second, "c" )
+	{
+	}
+
+	void check_positions( const ReparseConfig & other ) const
+	{
+		const cfgfile::tag_t<> * tags[] = { &m_cfg, &m_first, &m_a, &m_list,
+			&m_second, &m_b, &m_c };
+		const cfgfile::tag_t<> * other_tags[] = { &other.m_cfg, &other.m_first,
+			&other.m_a, &other.m_list, &other.m_second, &other.m_b, &other.m_c };
+
+		for( std::size_t i = 0; i < 7; ++i )
+		{
+			REQUIRE( tags[ i ]->offset() == other_tags[ i ]->offset() );
+			REQUIRE( tags[ i ]->line_number() == other_tags[ i ]->line_number() );
+			REQUIRE( tags[ i ]->column_number() ==
+				other_tags[ i ]->column_number() );
+			REQUIRE( tags[ i ]->end_offset() == other_tags[ i ]->end_offset() );
+			REQUIRE( tags[ i ]->end_line_number() ==
+				other_tags[ i ]->end_line_number() );
+			REQUIRE( tags[ i ]->end_column_number() ==
+				other_tags[ i ]->end_column_number() );
+		}
+	}
+
+	cfgfile::tag_no_value_t<> m_cfg;
+	cfgfile::tag_no_value_t<> m_first;
+	cfgfile::tag_scalar_t< int > m_a;
+	cfgfile::tag_scalar_vector_t< int > m_list;
+	cfgfile::tag_no_value_t<> m_second;
+	CountedScalarTag m_b;
+	cfgfile::tag_scalar_t< int > m_c;
+}; // struct ReparseConfig
+
+TEST_CASE( "test_reparse_cfgfile" )
+{
+	const std::string before =
+		"{cfg\n"
+		"  {first {a 1}\n"
+		"    {list 1 2 3}}\n"
+		"  {second {b 5}} }";
+
+	ReparseConfig cfg;
+
+	{
+		std::stringstream stream( before );
+
+		cfgfile::read_cfgfile( cfg.m_cfg, stream, "test" );
+	}
+
+	REQUIRE( cfg.m_list.values().size() == 3 );
+	REQUIRE( cfg.m_b.m_starts == 1 );
+	REQUIRE( cfg.m_first.offset() == before.find( "first" ) );
+	REQUIRE( cfg.m_first.end_offset() == before.find( "}}" ) + 1 );
+
+	// Edit inside of "list", new line added.
+	{
+		const std::string after =
+			"{cfg\n"
+			"  {first {a 1}\n"
+			"    {list 1 2\n 30 4}}\n"
+			"  {second {b 5}} }";
+
+		const cfgfile::text_edit_t<> edit = {
+			(std::streamoff) before.find( " 3}" ), 2, 6 };
+
+		std::stringstream stream( after );
+
+		const cfgfile::parse_result_t<> result =
+			cfgfile::reparse_cfgfile( cfg.m_cfg, stream, "test", edit );
+
+		REQUIRE( result.ok() );
+		REQUIRE( cfg.m_list.values() == std::vector< int >{ 1, 2, 30, 4 } );
+		REQUIRE( cfg.m_a.value() == 1 );
+		REQUIRE( cfg.m_b.value() == 5 );
+		REQUIRE( cfg.m_b.m_starts == 1 );
+
+		ReparseConfig full;
+
+		std::stringstream full_stream( after );
+
+		cfgfile::read_cfgfile( full.m_cfg, full_stream, "test" );
+
+		cfg.check_positions( full );
+	}
+
+	// Edit in "b" adds tag "c" to "second", "second" is parsed.
+	{
+		const std::string before_c =
+			"{cfg\n"
+			"  {first {a 1}\n"
+			"    {list 1 2\n 30 4}}\n"
+			"  {second {b 5}} }";
+		const std::string after =
+			"{cfg\n"
+			"  {first {a 1}\n"
+			"    {list 1 2\n 30 4}}\n"
+			"  {second {b 5} {c 6}} }";
+
+		const cfgfile::text_edit_t<> edit = {
+			(std::streamoff) before_c.find( "5}" ), 1, 7 };
+
+		std::stringstream stream( after );
+
+		const cfgfile::parse_result_t<> result =
+			cfgfile::reparse_cfgfile( cfg.m_cfg, stream, "test", edit );
+
+		REQUIRE( result.ok() );
+		REQUIRE( cfg.m_b.m_starts == 3 );
+		REQUIRE( cfg.m_b.value() == 5 );
+		REQUIRE( cfg.m_c.value() == 6 );
+		REQUIRE( cfg.m_list.values().size() == 4 );
+
+		ReparseConfig full;
+
+		std::stringstream full_stream( after );
+
+		cfgfile::read_cfgfile( full.m_cfg, full_stream, "test" );
+
+		cfg.check_positions( full );
+	}
+
+	// Mandatory tag removed, error is reported after parsing of the whole file.
+	{
+		const std::string after =
+			"{cfg\n"
+			"  {first {a 1}}\n"
+			"  {second {b 5} {c 6}} }";
+
+		const cfgfile::text_edit_t<> edit = { 19, 21, 0 };
+
+		std::stringstream stream( after );
+
+		const cfgfile::parse_result_t<> result =
+			cfgfile::reparse_cfgfile( cfg.m_cfg, stream, "test", edit );
+
+		REQUIRE( !result.ok() );
+		REQUIRE( result.code() ==
+			cfgfile::error_code_t::undefined_child_mandatory_tag );
+	}
+
+	// Invalid value.
+	{
+		const std::string after =
+			"{cfg\n"
+			"  {first {a x}\n"
+			"    {list 1}}\n"
+			"  {second {b 5}} }";
+
+		ReparseConfig fresh;
+
+		{
+			std::stringstream stream(
+				"{cfg\n"
+				"  {first {a 1}\n"
+				"    {list 1}}\n"
+				"  {second {b 5}} }" );
+
+			cfgfile::read_cfgfile( fresh.m_cfg, stream, "test" );
+		}
+
+		const cfgfile::text_edit_t<> edit = { 17, 1, 1 };
+
+		std::stringstream stream( after );
+
+		const cfgfile::parse_result_t<> result =
+			cfgfile::reparse_cfgfile( fresh.m_cfg, stream, "test", edit );
+
+		REQUIRE( !result.ok() );
+		REQUIRE( result.code() == cfgfile::error_code_t::invalid_value );
+		REQUIRE( result.line_number() == 2 );
+	}
+} // test_reparse_cfgfile
+
+TEST_CASE( "test_reparse_cfgfile_vector_of_tags" )
+{
+	const std::string before =
+		"{cfg {name abc}\n"
+		"  {server a} {server b} }";
+	const std::string after =
+		"{cfg {name abcd}\n"
+		"  {server a} {server b} }";
+
+	cfgfile::tag_no_value_t<> cfg( "cfg", true );
+	cfgfile::tag_scalar_t< std::string > name( cfg, "name" );
+	cfgfile::tag_vector_of_tags_t< cfgfile::tag_scalar_t< std::string > >
+		servers( cfg, "server" );
+
+	{
+		std::stringstream stream( before );
+
+		cfgfile::read_cfgfile( cfg, stream, "test" );
+	}
+
+	REQUIRE( servers.size() == 2 );
+	REQUIRE( servers.at( 0 ).end_offset() == before.find( "a}" ) + 1 );
+
+	const cfgfile::text_edit_t<> edit = {
+		(std::streamoff) before.find( "abc" ), 3, 4 };
+
+	std::stringstream stream( after );
+
+	const cfgfile::parse_result_t<> result =
+		cfgfile::reparse_cfgfile( cfg, stream, "test", edit );
+
+	REQUIRE( result.ok() );
+	REQUIRE( name.value() == "abcd" );
+	REQUIRE( servers.size() == 2 );
+
+	cfgfile::tag_no_value_t<> full( "cfg", true );
+	cfgfile::tag_scalar_t< std::string > full_name( full, "name" );
+	cfgfile::tag_vector_of_tags_t< cfgfile::tag_scalar_t< std::string > >
+		full_servers( full, "server" );
+
+	{
+		std::stringstream full_stream( after );
+
+		cfgfile::read_cfgfile( full, full_stream, "test" );
+	}
+
+	for( std::size_t i = 0; i < servers.size(); ++i )
+	{
+		REQUIRE( servers.at( i ).offset() == full_servers.at( i ).offset() );
+		REQUIRE( servers.at( i ).column_number() ==
+			full_servers.at( i ).column_number() );
+		REQUIRE( servers.at( i ).end_offset() ==
+			full_servers.at( i ).end_offset() );
+		REQUIRE( servers.at( i ).end_column_number() ==
+			full_servers.at( i ).end_column_number() );
+	}
+} // test_reparse_cfgfile_vector_of_tags
+
+struct DiffConfig {
+	DiffConfig()
+		:	m_cfg( "cfg", true )
+		,	m_name( m_cfg, "name", true )
+		,	m_ports( m_cfg, "ports" )
+		,	m_debug( m_cfg, "debug" )
+		,	m_servers( m_cfg, "server" )
+	{
+	}
+
+	void read( const std::string & data )
+	{
+		std::stringstream stream( data );
+
+		cfgfile::read_cfgfile( m_cfg, stream, "test" );
+	}
+
+	cfgfile::tag_no_value_t<> m_cfg;
+	cfgfile::tag_scalar_t< std::string > m_name;
+	cfgfile::tag_scalar_vector_t< int > m_ports;
+	cfgfile::tag_no_value_t<> m_debug;
+	cfgfile::tag_vector_of_tags_t< cfgfile::tag_scalar_t< std::string > >
+		m_servers;
+}; // struct DiffConfig
+
+TEST_CASE( "test_diff" )
+{
+	DiffConfig before;
+	before.read( "{cfg {name \"a b\"} {ports 1 2} {debug} "
+		"{server one} {server two}}" );
+
+	DiffConfig same;
+	same.read( "{cfg {name \"a b\"} {ports 1 2} {debug} "
+		"{server one} {server two}}" );
+
+	REQUIRE( cfgfile::diff( before.m_cfg, same.m_cfg ).empty() );
+
+	DiffConfig after;
+	after.read( "{cfg {name \"a b\"} {ports 1 3} "
+		"{server one} {server three} {server four}}" );
+
+	const std::vector< cfgfile::diff_entry_t<> > d =
+		cfgfile::diff( before.m_cfg, after.m_cfg );
+
+	REQUIRE( d.size() == 4 );
+
+	REQUIRE( d.at( 0 ).m_kind == cfgfile::diff_kind_t::changed );
+	REQUIRE( d.at( 0 ).m_path == "cfg.ports" );
+	REQUIRE( d.at( 0 ).m_old_values == "1 2" );
+	REQUIRE( d.at( 0 ).m_new_values == "1 3" );
+
+	REQUIRE( d.at( 1 ).m_kind == cfgfile::diff_kind_t::removed );
+	REQUIRE( d.at( 1 ).m_path == "cfg.debug" );
+
+	REQUIRE( d.at( 2 ).m_kind == cfgfile::diff_kind_t::changed );
+	REQUIRE( d.at( 2 ).m_path == "cfg.server[1]" );
+	REQUIRE( d.at( 2 ).m_old_values == "two" );
+	REQUIRE( d.at( 2 ).m_new_values == "three" );
+
+	REQUIRE( d.at( 3 ).m_kind == cfgfile::diff_kind_t::added );
+	REQUIRE( d.at( 3 ).m_path == "cfg.server[2]" );
+	REQUIRE( d.at( 3 ).m_new_values == "four" );
+} // test_diff
+
+TEST_CASE( "test_content_hash" )
+{
+	DiffConfig before;
+	before.read( "{cfg {name \"a b\"} {ports 1 2} {server one}}" );
+
+	DiffConfig after;
+	after.read( "{cfg {name \"a b\"} {ports 1 3} {server one}}" );
+
+	REQUIRE( before.m_name.content_hash() == after.m_name.content_hash() );
+	REQUIRE( before.m_servers.content_hash() ==
+		after.m_servers.content_hash() );
+	REQUIRE( before.m_ports.content_hash() != after.m_ports.content_hash() );
+	REQUIRE( before.m_cfg.content_hash() != after.m_cfg.content_hash() );
+
+	after.m_ports.set_values( { 1, 2 } );
+
+	REQUIRE( before.m_ports.content_hash() == after.m_ports.content_hash() );
+	REQUIRE( before.m_cfg.content_hash() == after.m_cfg.content_hash() );
+
+	after.m_debug.set_defined();
+
+	REQUIRE( before.m_debug.content_hash() != after.m_debug.content_hash() );
+	REQUIRE( before.m_cfg.content_hash() != after.m_cfg.content_hash() );
+} // test_content_hash
+
+TEST_CASE( "test_content_hash_vector_of_tags" )
+{
+	DiffConfig before;
+	before.read( "{cfg {name \"a b\"} {server one}}" );
+
+	DiffConfig after;
+	after.read( "{cfg {name \"a b\"} {server one}}" );
+
+	REQUIRE( before.m_cfg.content_hash() == after.m_cfg.content_hash() );
+
+	const auto saved = after.m_servers.values();
+
+	auto two = std::make_shared< cfgfile::tag_scalar_t< std::string > > (
+		"server", false );
+	two->set_value( "two" );
+
+	after.m_servers.set_value( two );
+
+	REQUIRE( before.m_cfg.content_hash() != after.m_cfg.content_hash() );
+
+	const std::vector< cfgfile::diff_entry_t<> > d =
+		cfgfile::diff( before.m_cfg, after.m_cfg );
+
+	REQUIRE( d.size() == 1 );
+	REQUIRE( d.at( 0 ).m_kind == cfgfile::diff_kind_t::added );
+	REQUIRE( d.at( 0 ).m_path == "cfg.server[1]" );
+	REQUIRE( d.at( 0 ).m_new_values == "two" );
+
+	after.m_servers.set_values( saved );
+
+	REQUIRE( before.m_cfg.content_hash() == after.m_cfg.content_hash() );
+	REQUIRE( cfgfile::diff( before.m_cfg, after.m_cfg ).empty() );
+
+	after.m_servers.clear();
+
+	REQUIRE( before.m_cfg.content_hash() != after.m_cfg.content_hash() );
+	REQUIRE( cfgfile::diff( before.m_cfg, after.m_cfg ).size() == 1 );
+} // test_content_hash_vector_of_tags
+
+class CountedPrintTag
+	:	public cfgfile::tag_scalar_t< double >
+{
+public:
+	CountedPrintTag( cfgfile::tag_t<> & owner, const std::string & name )
+		:	cfgfile::tag_scalar_t< double >( owner, name )
+		,	m_prints( 0 )
+	{
+	}
+
+	std::string print_values() const override
+	{
+		++m_prints;
+
+		return cfgfile::tag_scalar_t< double >::print_values();
+	}
+
+	mutable int m_prints;
+}; // class CountedPrintTag
+
+TEST_CASE( "test_content_hash_is_lazy" )
+{
+	cfgfile::tag_no_value_t<> cfg( "cfg", true );
+	CountedPrintTag value( cfg, "value" );
+
+	std::stringstream stream( "{cfg {value 0.1}}" );
+
+	cfgfile::read_cfgfile( cfg, stream, "test" );
+
+	REQUIRE( value.m_prints == 0 );
+
+	const std::uint64_t h = cfg.content_hash();
+
+	REQUIRE( value.m_prints == 1 );
+	REQUIRE( cfg.content_hash() == h );
+	REQUIRE( value.m_prints == 1 );
+} // test_content_hash_is_lazy
+
+TEST_CASE( "test_read_xml" )
+{
+	DiffConfig cfg;
+	cfg.read( "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		"<!DOCTYPE cfg>\n"
+		"<!-- Comment. -->\n"
+		"<cfg>\n"
+		"    <name>&quot;a &amp; b&quot;</name>\n"
+		"    <ports a2=\"3\" a1='1'/>\n"
+		"    <debug></debug>\n"
+		"    <server><![CDATA[<one>]]></server>\n"
+		"    <!-- Comment. -->\n"
+		"    <server>t&#119;o &#1055;</server>\n"
+		"</cfg>\n" );
+
+	REQUIRE( cfg.m_name.value() == "a & b" );
+	REQUIRE( cfg.m_ports.values() == std::vector< int >{ 1, 3 } );
+	REQUIRE( cfg.m_debug.is_defined() );
+	REQUIRE( cfg.m_servers.size() == 2 );
+	REQUIRE( cfg.m_servers.at( 0 ).value() == "<one>" );
+	REQUIRE( cfg.m_servers.at( 1 ).value() == "two \xD0\x9F" );
+
+	std::wstringstream stream( L"<cfg>&#x1F642;<child>42</child></cfg>" );
+
+	cfgfile::tag_scalar_t< std::wstring, cfgfile::wstring_trait_t > tag(
+		L"cfg", true );
+	cfgfile::tag_scalar_t< int, cfgfile::wstring_trait_t > child(
+		tag, L"child", true );
+
+	cfgfile::read_cfgfile( tag, stream, L"test" );
+
+	std::wstring expected;
+
+	if( sizeof( wchar_t ) == 2 )
+		expected.append( { wchar_t( 0xD83D ), wchar_t( 0xDE42 ) } );
+	else
+		expected.push_back( wchar_t( 0x1F642 ) );
+
+	REQUIRE( tag.value() == expected );
+	REQUIRE( child.value() == 42 );
+} // test_read_xml
+
+class PositionsTag
+	:	public cfgfile::tag_scalar_vector_t< int >
+{
+public:
+	PositionsTag( cfgfile::tag_t<> & owner, const std::string & name )
+		:	cfgfile::tag_scalar_vector_t< int >( owner, name )
+	{
+	}
+
+	void on_string( const cfgfile::parser_info_t<> & info,
+		const std::string & str ) override
+	{
+		m_positions.push_back( std::make_pair( info.line_number(),
+			info.column_number() ) );
+
+		cfgfile::tag_scalar_vector_t< int >::on_string( info, str );
+	}
+
+	std::vector< std::pair< std::streamoff, std::streamoff > > m_positions;
+}; // class PositionsTag
+
+TEST_CASE( "test_read_xml_attribute_positions" )
+{
+	cfgfile::tag_no_value_t<> cfg( "cfg", true );
+	PositionsTag ports( cfg, "ports" );
+
+	std::stringstream stream( "<cfg>\n"
+		"    <ports a2=\"2\" a1=\"1\"/>\n"
+		"</cfg>\n" );
+
+	cfgfile::read_cfgfile( cfg, stream, "test" );
+
+	REQUIRE( ports.values() == std::vector< int >{ 1, 2 } );
+	REQUIRE( ports.m_positions.size() == 2 );
+	REQUIRE( ports.line_number() == 2 );
+
+	for( const auto & pos : ports.m_positions )
+	{
+		REQUIRE( pos.first == ports.line_number() );
+		REQUIRE( pos.second == ports.column_number() );
+	}
+} // test_read_xml_attribute_positions
+
+TEST_CASE( "test_read_xml_errors" )
+{
+	{
+		DiffConfig cfg;
+
+		try {
+			cfg.read( "<cfg>\n<name>a</cfg>" );
+
+			REQUIRE( false );
+		}
+		catch( const cfgfile::exception_t<> & x )
+		{
+			REQUIRE( x.desc() == "Unable to parse XML from file: \"test\". "
+				"\"Opening and ending tag mismatch.\" On line 2, column 13." );
+		}
+	}
+
+	{
+		DiffConfig cfg;
+
+		try {
+			cfg.read( "<cfg>\n<unknown/>\n</cfg>" );
+
+			REQUIRE( false );
+		}
+		catch( const cfgfile::exception_t<> & x )
+		{
+			REQUIRE( x.desc() == "Unexpected tag name. We expected one child "
+				"tag of tag \"cfg\", but we've got \"unknown\". "
+				"In file \"test\" on line 2." );
+		}
+	}
+
+	{
+		DiffConfig cfg;
+
+		try {
+			cfg.read( "<cfg>\n<unknown/>\n<name>&nbsp;</name>" );
+
+			REQUIRE( false );
+		}
+		catch( const cfgfile::exception_t<> & x )
+		{
+			REQUIRE( x.desc() == "Unable to parse XML from file: \"test\". "
+				"\"Entity 'nbsp' not declared.\" On line 3, column 12." );
+		}
+	}
+
+	{
+		DiffConfig cfg;
+
+		try {
+			cfg.read( "<cfg><name>a</name></cfg>\n<cfg/>" );
+
+			REQUIRE( false );
+		}
+		catch( const cfgfile::exception_t<> & x )
+		{
+			REQUIRE( x.desc() == "Unable to parse XML from file: \"test\". "
+				"\"Extra content at end of document.\" On line 2, column 1." );
+		}
+	}
+} // test_read_xml_errors
+
+TEST_CASE( "test_parse_limits" )
+{
+	cfgfile::parse_limits_t limits;
+	limits.m_max_depth = 2;
+	limits.m_max_lexeme_length = 8;
+	limits.m_max_values = 3;
+	limits.m_max_elements = 2;
+	limits.m_max_size = 128;
+
+	{
+		DiffConfig cfg;
+		std::stringstream stream( "{cfg {name \"a b\"} {ports 1 2 3} "
+			"{server one} {server two}}" );
+
+		REQUIRE( cfgfile::try_read_cfgfile( cfg.m_cfg, stream, "test",
+			limits ) );
+	}
+
+	{
+		cfgfile::tag_no_value_t<> cfg( "cfg", true );
+		cfgfile::tag_no_value_t<> child( cfg, "child" );
+		cfgfile::tag_no_value_t<> grand_child( child, "child" );
+		std::stringstream stream( "{cfg {child {child}}}" );
+
+		const auto result = cfgfile::try_read_cfgfile( cfg, stream, "test",
+			limits );
+
+		REQUIRE( result.code() == cfgfile::error_code_t::limit_exceeded );
+		REQUIRE( result.desc() == "Limit \"depth\" exceeded. "
+			"In file \"test\" on line 1." );
+	}
+
+	{
+		DiffConfig cfg;
+		std::stringstream stream( "{cfg {name \"a long name\"}}" );
+
+		const auto result = cfgfile::try_read_cfgfile( cfg.m_cfg, stream,
+			"test", limits );
+
+		REQUIRE( result.desc() == "Limit \"lexeme length\" exceeded. "
+			"In file \"test\" on line 1." );
+	}
+
+	{
+		DiffConfig cfg;
+		std::stringstream stream( "{cfg {name a} {ports 1 2 3 4}}" );
+
+		const auto result = cfgfile::try_read_cfgfile( cfg.m_cfg, stream,
+			"test", limits );
+
+		REQUIRE( result.desc() == "Limit \"values\" exceeded. "
+			"In file \"test\" on line 1." );
+		REQUIRE( result.tag_name() == "ports" );
+	}
+
+	{
+		DiffConfig cfg;
+		std::stringstream stream( "{cfg {name a}\n"
+			"{server one}\n{server two}\n{server three}}" );
+
+		const auto errors = cfgfile::validate_cfgfile( cfg.m_cfg, stream,
+			"test", limits );
+
+		REQUIRE( errors.size() == 1 );
+		REQUIRE( errors.at( 0 ).desc() == "Limit \"elements\" exceeded. "
+			"In file \"test\" on line 4." );
+		REQUIRE( cfg.m_servers.size() == 2 );
+	}
+
+	{
+		DiffConfig cfg;
+		std::stringstream stream( "{cfg {name a}\n" +
+			std::string( 200, ' ' ) + "{server one}}" );
+
+		const auto result = cfgfile::try_read_cfgfile( cfg.m_cfg, stream,
+			"test", limits );
+
+		REQUIRE( result.desc() == "Limit \"size\" exceeded. "
+			"In file \"test\" on line 2." );
+	}
+
+	{
+		cfgfile::tag_no_value_t<> cfg( "cfg", true );
+		cfgfile::tag_no_value_t<> child( cfg, "child" );
+		cfgfile::tag_no_value_t<> grand_child( child, "child" );
+		std::stringstream stream( "<cfg><child><child/></child></cfg>" );
+
+		try {
+			cfgfile::read_cfgfile( cfg, stream, "test", limits );
+
+			REQUIRE( false );
+		}
+		catch( const cfgfile::exception_t<> & x )
+		{
+			REQUIRE( x.code() == cfgfile::error_code_t::limit_exceeded );
+		}
+	}
+
+	{
+		DiffConfig cfg;
+		std::stringstream stream( "<cfg><name>a long name</name></cfg>" );
+
+		const auto result = cfgfile::try_read_cfgfile( cfg.m_cfg, stream,
+			"test", limits );
+
+		REQUIRE( result.desc() == "Limit \"lexeme length\" exceeded. "
+			"In file \"test\" on line 1." );
+	}
+
+	{
+		DiffConfig cfg;
+		std::string data = "<cfg><name>";
+
+		for( int i = 0; i < 1000; ++i )
+			data.append( "&#65;" );
+
+		data.append( "</name></cfg>" );
+
+		std::stringstream stream( data );
+
+		cfgfile::parse_limits_t length_limits;
+		length_limits.m_max_lexeme_length = 10;
+
+		const auto result = cfgfile::try_read_cfgfile( cfg.m_cfg, stream,
+			"test", length_limits );
+
+		REQUIRE( result.desc() == "Limit \"lexeme length\" exceeded. "
+			"In file \"test\" on line 1." );
+	}
+
+	{
+		cfgfile::tag_no_value_t<> cfg( "cfg", true );
+		cfgfile::tag_no_value_t<> child( cfg, "child" );
+		cfgfile::tag_no_value_t<> grand_child( child, "child" );
+
+		std::string data;
+
+		for( int i = 0; i < 100000; ++i )
+			data.append( "<child>" );
+
+		std::stringstream stream( "<cfg>" + data );
+
+		cfgfile::parse_limits_t depth_limits;
+		depth_limits.m_max_depth = 2;
+
+		// Rest of the input isn't read after the limit.
+		const auto result = cfgfile::try_read_cfgfile( cfg, stream, "test",
+			depth_limits );
+
+		REQUIRE( result.desc() == "Limit \"depth\" exceeded. "
+			"In file \"test\" on line 1." );
+	}
+
+	{
+		DiffConfig cfg;
+		std::stringstream stream( "<cfg><name>a</name>"
+			"<ports a1=\"1\" a2=\"2\" a3=\"3\" a4=\"4\"/></cfg>" );
+
+		const auto result = cfgfile::try_read_cfgfile( cfg.m_cfg, stream,
+			"test", limits );
+
+		REQUIRE( result.desc() == "Limit \"values\" exceeded. "
+			"In file \"test\" on line 1." );
+		REQUIRE( result.tag_name() == "ports" );
+	}
+
+	{
+		DiffConfig cfg;
+		std::stringstream stream( "<cfg><name>a</name>\n<!-- " +
+			std::string( 200, ' ' ) + " --></cfg>" );
+
+		const auto result = cfgfile::try_read_cfgfile( cfg.m_cfg, stream,
+			"test", limits );
+
+		REQUIRE( result.desc() == "Limit \"size\" exceeded. "
+			"In file \"test\" on line 2." );
+	}
+
+	{
+		cfgfile::parse_limits_t size_limits;
+		size_limits.m_max_size = 16;
+
+		DiffConfig cfg;
+		std::stringstream stream( "{cfg {name \"" + std::string( 200, 'a' ) +
+			"\"}}" );
+
+		const auto result = cfgfile::try_read_cfgfile( cfg.m_cfg, stream,
+			"test", size_limits );
+
+		// Found while the long lexeme is read.
+		REQUIRE( result.code() == cfgfile::error_code_t::limit_exceeded );
+		REQUIRE( result.column_number() == 12 );
+	}
+
+	{
+		cfgfile::parser_context_t<> context;
+		context.set_limits( limits );
+
+		cfgfile::tag_no_value_t<> cfg( "cfg", true );
+		cfgfile::tag_no_value_t<> child( cfg, "child" );
+		cfgfile::tag_no_value_t<> grand_child( child, "child" );
+
+		for( const char * text : { "{cfg {child {child}}}",
+			"<cfg><child><child/></child></cfg>" } )
+		{
+			std::stringstream stream( text );
+
+			try {
+				cfgfile::read_cfgfile( cfg, stream, "test", context );
+
+				REQUIRE( false );
+			}
+			catch( const cfgfile::exception_t<> & x )
+			{
+				REQUIRE( x.code() == cfgfile::error_code_t::limit_exceeded );
+			}
+		}
+	}
+} // test_parse_limits
@@ -11,6 +11,9 @@
 // cfgfile include.
 #include <cfgfile/all.hpp>
 
+// Qt include.
+#include <QBuffer>
+
 
 TEST_CASE( "test_undefined_first_mandatory_tag" )
 {
@@ -105,3 +108,187 @@ TEST_CASE( "test_cant_set_xml" )
 			"On line 1, column 6." );
 	}
 }
+
+TEST_CASE( "test_read_xml_stream" )
+{
+	QTextStream s( "<cfg>\n\t<name>\"a b\"</name>\n"
+		"\t<ports a1=\"1\" a2=\"2\"></ports>\n</cfg>" );
+
+	cfgfile::tag_no_value_t< cfgfile::qstring_trait_t > cfg( "cfg", true );
+	cfgfile::tag_scalar_t< QString, cfgfile::qstring_trait_t > name( cfg,
+		"name", true );
+	cfgfile::tag_scalar_vector_t< int, cfgfile::qstring_trait_t > ports( cfg,
+		"ports" );
+
+	cfgfile::read_cfgfile( cfg, s, "test_read_xml_stream" );
+
+	REQUIRE( name.value() == QStringLiteral( "a b" ) );
+	REQUIRE( ports.values().size() == 2 );
+	REQUIRE( ports.values().at( 0 ) == 1 );
+	REQUIRE( ports.values().at( 1 ) == 2 );
+}
+
+TEST_CASE( "test_xml_stream_unexpected_child_tag" )
+{
+	QTextStream s( "<cfg>\n<wrong></wrong></cfg>" );
+
+	cfgfile::tag_no_value_t< cfgfile::qstring_trait_t > tag( "cfg", true );
+
+	try {
+		cfgfile::read_cfgfile( tag, s, "test_xml_stream_unexpected_child_tag" );
+
+		REQUIRE( false );
+	}
+	catch( const cfgfile::exception_t< cfgfile::qstring_trait_t > & x )
+	{
+		REQUIRE( x.desc() == "Unexpected tag name. "
+			"We expected one child tag of tag \"cfg\", but we've got \"wrong\". "
+			"In file \"test_xml_stream_unexpected_child_tag\" on line 2." );
+	}
+}
+
+TEST_CASE( "test_xml_attributes_order" )
+{
+	QTextStream s( "<cfg><ports a3=\"3\" b=\"x\" a1=\"1\" a2=\"2\"/>"
+		"<names a2=\"c\\td\" a1=\"a b\"/></cfg>" );
+
+	cfgfile::tag_no_value_t< cfgfile::qstring_trait_t > cfg( "cfg", true );
+	cfgfile::tag_scalar_vector_t< int, cfgfile::qstring_trait_t > ports( cfg,
+		"ports" );
+	cfgfile::tag_scalar_vector_t< QString, cfgfile::qstring_trait_t > names(
+		cfg, "names" );
+
+	cfgfile::read_cfgfile( cfg, s, "test_xml_attributes_order" );
+
+	REQUIRE( ports.values().size() == 3 );
+	REQUIRE( ports.values().at( 0 ) == 1 );
+	REQUIRE( ports.values().at( 1 ) == 2 );
+	REQUIRE( ports.values().at( 2 ) == 3 );
+
+	REQUIRE( names.values().size() == 2 );
+	REQUIRE( names.values().at( 0 ) == QStringLiteral( "a b" ) );
+	REQUIRE( names.values().at( 1 ) == QStringLiteral( "c\td" ) );
+}
+
+class PositionsTag
+	:	public cfgfile::tag_scalar_vector_t< int, cfgfile::qstring_trait_t >
+{
+public:
+	PositionsTag( cfgfile::tag_t< cfgfile::qstring_trait_t > & owner,
+		const QString & name )
+		:	cfgfile::tag_scalar_vector_t< int, cfgfile::qstring_trait_t >(
+				owner, name )
+	{
+	}
+
+	void on_string(
+		const cfgfile::parser_info_t< cfgfile::qstring_trait_t > & info,
+		const QString & str ) override
+	{
+		m_positions.push_back( std::make_pair( info.line_number(),
+			info.column_number() ) );
+
+		cfgfile::tag_scalar_vector_t< int, cfgfile::qstring_trait_t >::on_string(
+			info, str );
+	}
+
+	std::vector< std::pair< qint64, qint64 > > m_positions;
+}; // class PositionsTag
+
+TEST_CASE( "test_xml_attribute_positions" )
+{
+	QTextStream s( "<cfg>\n"
+		"    <ports a2=\"2\" a1=\"1\"/>\n"
+		"</cfg>\n" );
+
+	cfgfile::tag_no_value_t< cfgfile::qstring_trait_t > cfg( "cfg", true );
+	PositionsTag ports( cfg, "ports" );
+
+	cfgfile::read_cfgfile( cfg, s, "test_xml_attribute_positions" );
+
+	REQUIRE( ports.values().size() == 2 );
+	REQUIRE( ports.m_positions.size() == 2 );
+	REQUIRE( ports.line_number() == 2 );
+
+	// Like in DOM attributes have no position.
+	for( const auto & pos : ports.m_positions )
+	{
+		REQUIRE( pos.first == -1 );
+		REQUIRE( pos.second == -1 );
+	}
+}
+
+TEST_CASE( "test_write_xml_stream" )
+{
+	cfgfile::tag_no_value_t< cfgfile::qstring_trait_t > cfg( "cfg", true );
+	cfgfile::tag_scalar_t< QString, cfgfile::qstring_trait_t > name( cfg,
+		"name", true );
+	cfgfile::tag_scalar_vector_t< int, cfgfile::qstring_trait_t > ports( cfg,
+		"ports" );
+
+	name.set_value( QStringLiteral( "a \"b\"" ) );
+	ports.set_value( 1 );
+	ports.set_value( 2 );
+	cfg.set_defined();
+
+	QString data;
+
+	{
+		QTextStream out( &data );
+
+		cfgfile::write_cfgfile( cfg, out, cfgfile::file_format_t::xml_format );
+	}
+
+	REQUIRE( data.startsWith( QStringLiteral( "<cfg>" ) ) );
+
+	cfgfile::tag_no_value_t< cfgfile::qstring_trait_t > read( "cfg", true );
+	cfgfile::tag_scalar_t< QString, cfgfile::qstring_trait_t > read_name( read,
+		"name", true );
+	cfgfile::tag_scalar_vector_t< int, cfgfile::qstring_trait_t > read_ports(
+		read, "ports" );
+
+	QTextStream in( &data );
+
+	cfgfile::read_cfgfile( read, in, "test_write_xml_stream" );
+
+	REQUIRE( read_name.value() == QStringLiteral( "a \"b\"" ) );
+	REQUIRE( read_ports.values().size() == 2 );
+	REQUIRE( read_ports.values().at( 0 ) == 1 );
+	REQUIRE( read_ports.values().at( 1 ) == 2 );
+}
+
+TEST_CASE( "test_xml_stream_encoding" )
+{
+	cfgfile::tag_no_value_t< cfgfile::qstring_trait_t > cfg( "cfg", true );
+	cfgfile::tag_scalar_t< QString, cfgfile::qstring_trait_t > name( cfg,
+		"name", true );
+
+	name.set_value( QStringLiteral( "\u00E4" ) );
+	cfg.set_defined();
+
+	QBuffer buffer;
+	buffer.open( QIODevice::ReadWrite );
+
+	{
+		QTextStream out( &buffer );
+		out.setEncoding( QStringConverter::Latin1 );
+
+		cfgfile::write_cfgfile( cfg, out, cfgfile::file_format_t::xml_format );
+	}
+
+	REQUIRE( buffer.data().contains( '\xE4' ) );
+	REQUIRE( !buffer.data().contains( "\xC3\xA4" ) );
+
+	cfgfile::tag_no_value_t< cfgfile::qstring_trait_t > read( "cfg", true );
+	cfgfile::tag_scalar_t< QString, cfgfile::qstring_trait_t > read_name( read,
+		"name", true );
+
+	buffer.seek( 0 );
+
+	QTextStream in( &buffer );
+	in.setEncoding( QStringConverter::Latin1 );
+
+	cfgfile::read_cfgfile( read, in, "test_xml_stream_encoding" );
+
+	REQUIRE( read_name.value() == QStringLiteral( "\u00E4" ) );
+}